@@ -1,9 +1,15 @@
-#include <cassert>
+#include <algorithm>
+#include <chrono>
 #include <cstdlib>
+#include <functional>
 #include <iostream>
+#include <memory>
 #include <set>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 
 class Observer
 {
@@ -12,24 +18,63 @@ public:
     virtual ~Observer() {}
 };
 
+using Topic = unsigned int;
+using TopicFilter = std::function<bool(Topic)>;
+
+namespace Topics
+{
+    constexpr Topic state_changed = 0;
+}
+
 class Subject
 {
     int state_;
     std::set<Observer*> observers_;
+    std::vector<std::pair<Observer*, TopicFilter>> filters_;
+    std::unordered_map<Topic, std::vector<Observer*>> dispatch_table_; // observers interested in a topic - only topics in use have a row
 
 public:
     Subject() : state_(0)
     {
     }
 
+    // subscription for all topics
     void register_observer(Observer* observer)
+    {
+        register_observer(observer, [](Topic) { return true; });
+    }
+
+    void register_observer(Observer* observer, Topic topic)
+    {
+        observers_.insert(observer);
+        add_to_row(row_of(topic), observer);
+    }
+
+    // filter is evaluated once per topic - when the subscription is made or when a topic is used for the first time
+    void register_observer(Observer* observer, TopicFilter filter)
     {
         observers_.insert(observer);
+
+        for (auto& [topic, row] : dispatch_table_)
+        {
+            if (filter(topic))
+                add_to_row(row, observer);
+        }
+
+        filters_.emplace_back(observer, std::move(filter));
     }
 
     void unregister_observer(Observer* observer)
     {
-        observers_.erase(observer);
+        if (observers_.erase(observer) == 0)
+            return;
+
+        filters_.erase(std::remove_if(filters_.begin(), filters_.end(),
+                           [observer](const auto& f) { return f.first == observer; }),
+            filters_.end());
+
+        for (auto& [topic, row] : dispatch_table_)
+            row.erase(std::remove(row.begin(), row.end(), observer), row.end());
     }
 
     void set_state(int new_state)
@@ -37,18 +82,47 @@ public:
         if (state_ != new_state)
         {
             state_ = new_state;
-            notify("Changed state on: " + std::to_string(state_));
+            notify(Topics::state_changed, "Changed state on: " + std::to_string(state_));
         }
     }
 
+    void publish(Topic topic, const std::string& event_args)
+    {
+        notify(topic, event_args);
+    }
+
 protected:
-    void notify(const std::string& event_args)
+    void notify(Topic topic, const std::string& event_args)
     {
-        for (Observer* observer : observers_)
+        for (Observer* observer : row_of(topic))
         {
             observer->update(event_args);
         }
     }
+
+private:
+    // a row of a topic used for the first time is filled with matching filter subscriptions
+    std::vector<Observer*>& row_of(Topic topic)
+    {
+        auto [it, inserted] = dispatch_table_.try_emplace(topic);
+
+        if (inserted)
+        {
+            for (const auto& [observer, filter] : filters_)
+            {
+                if (filter(topic))
+                    it->second.push_back(observer);
+            }
+        }
+
+        return it->second;
+    }
+
+    static void add_to_row(std::vector<Observer*>& row, Observer* observer)
+    {
+        if (std::find(row.begin(), row.end(), observer) == row.end())
+            row.push_back(observer);
+    }
 };
 
 class ConcreteObserver1 : public Observer
@@ -69,10 +143,117 @@ public:
     }
 };
 
+//////////////////////////////////////////////
+// fan-out benchmark: broadcast + filtering in update() vs. topic dispatch table
+
+class FilteringObserver : public Observer
+{
+    std::string topic_prefix_;
+
+public:
+    size_t hits = 0;
+
+    explicit FilteringObserver(Topic topic)
+        : topic_prefix_ {"topic-" + std::to_string(topic) + ":"}
+    {
+    }
+
+    void update(const std::string& event) override
+    {
+        if (std::string_view(event).substr(0, topic_prefix_.size()) == topic_prefix_)
+            ++hits;
+    }
+};
+
+class CountingObserver : public Observer
+{
+public:
+    size_t hits = 0;
+
+    void update(const std::string&) override
+    {
+        ++hits;
+    }
+};
+
+class BroadcastSubject : public Subject
+{
+public:
+    using Subject::notify;
+};
+
+void benchmark_fan_out(size_t no_of_observers, Topic no_of_topics, size_t no_of_events)
+{
+    using namespace std::chrono;
+
+    std::vector<std::string> events;
+    for (Topic topic = 0; topic < no_of_topics; ++topic)
+        events.push_back("topic-" + std::to_string(topic) + ": event");
+
+    std::vector<std::unique_ptr<FilteringObserver>> filtering_observers;
+    std::vector<std::unique_ptr<CountingObserver>> counting_observers;
+
+    BroadcastSubject broadcast_subject;
+    Subject topic_subject;
+
+    for (size_t i = 0; i < no_of_observers; ++i)
+    {
+        const Topic topic = static_cast<Topic>(i % no_of_topics);
+
+        filtering_observers.push_back(std::make_unique<FilteringObserver>(topic));
+        broadcast_subject.register_observer(filtering_observers.back().get());
+
+        counting_observers.push_back(std::make_unique<CountingObserver>());
+        topic_subject.register_observer(counting_observers.back().get(), topic);
+    }
+
+    auto start = steady_clock::now();
+    for (size_t i = 0; i < no_of_events; ++i)
+    {
+        const Topic topic = static_cast<Topic>(i % no_of_topics);
+        broadcast_subject.notify(topic, events[topic]);
+    }
+    auto broadcast_time = duration_cast<microseconds>(steady_clock::now() - start);
+
+    start = steady_clock::now();
+    for (size_t i = 0; i < no_of_events; ++i)
+    {
+        const Topic topic = static_cast<Topic>(i % no_of_topics);
+        topic_subject.publish(topic, events[topic]);
+    }
+    auto dispatch_time = duration_cast<microseconds>(steady_clock::now() - start);
+
+    size_t broadcast_hits = 0;
+    for (const auto& o : filtering_observers)
+        broadcast_hits += o->hits;
+
+    size_t dispatch_hits = 0;
+    for (const auto& o : counting_observers)
+        dispatch_hits += o->hits;
+
+    // checked explicitly - the benchmark is meant to be run in a Release (NDEBUG) build
+    if (broadcast_hits != dispatch_hits)
+        throw std::logic_error("benchmark_fan_out: broadcast & dispatch delivered different numbers of events");
+
+    std::cout << "observers: " << no_of_observers << "; topics: " << no_of_topics
+              << "; events: " << no_of_events << "; deliveries: " << dispatch_hits << "\n"
+              << "  broadcast + filter in update: " << broadcast_time.count() << " us\n"
+              << "  topic dispatch table:         " << dispatch_time.count() << " us\n";
+}
+
 int main(int argc, char const* argv[])
 {
     using namespace std;
 
+    if (argc > 1 && argv[1] == "--bench"s)
+    {
+        for (Topic no_of_topics : {8u, 32u, 64u})
+            for (size_t no_of_observers : {1'000u, 4'000u, 16'000u})
+                benchmark_fan_out(no_of_observers, no_of_topics, 10'000);
+
+        return 0;
+    }
+
     Subject s;
 
     ConcreteObserver1* o1 = new ConcreteObserver1;
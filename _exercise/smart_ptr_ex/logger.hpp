@@ -0,0 +1,253 @@
+#ifndef LOGGER_HPP
+#define LOGGER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+enum class LogEvent : uint32_t
+{
+    gadget_used,
+    gadget_destroyed
+};
+
+struct LogRecord
+{
+    int64_t timestamp_ns;
+    LogEvent event;
+    int32_t gadget_id;
+};
+
+inline const char* to_string(LogEvent event)
+{
+    switch (event)
+    {
+    case LogEvent::gadget_used:
+        return "Player is using a gadget: ";
+    case LogEvent::gadget_destroyed:
+        return "Destroing a gadget: ";
+    }
+
+    return "Unknown event: ";
+}
+
+class Logger
+{
+public:
+    virtual void log(LogEvent event, int gadget_id) = 0;
+    virtual ~Logger() = default;
+};
+
+/////////////////////////////////////////////////////////////////
+// Logger writing synchronously - every record is flushed
+//
+class OStreamLogger : public Logger
+{
+    std::ostream& out_;
+
+public:
+    explicit OStreamLogger(std::ostream& out)
+        : out_ {out}
+    {
+    }
+
+    void log(LogEvent event, int gadget_id) override
+    {
+        out_ << to_string(event) << gadget_id << std::endl;
+    }
+};
+
+/////////////////////////////////////////////////////////////////
+// Bounded lock-free multi-producer queue (single consumer)
+//
+// Every cell has a sequence number telling whether it is ready to be
+// written (sequence == position) or read (sequence == position + 1).
+//
+template <typename T>
+class RingBuffer
+{
+    struct alignas(64) Cell
+    {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    const size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+    alignas(64) std::atomic<size_t> enqueue_pos_ {0};
+    alignas(64) size_t dequeue_pos_ {0};
+
+public:
+    // capacity must be a power of 2 - positions are mapped to cells with a mask
+    explicit RingBuffer(size_t capacity)
+        : mask_ {checked_capacity(capacity) - 1}
+        , cells_ {std::make_unique<Cell[]>(capacity)}
+    {
+        for (size_t i = 0; i < capacity; ++i)
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    // returns false if the buffer is full
+    bool try_push(const T& value) noexcept
+    {
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+
+        while (true)
+        {
+            Cell& cell = cells_[pos & mask_];
+            const size_t seq = cell.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+
+            if (diff == 0)
+            {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    cell.value = value;
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+                return false;
+            else
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+        }
+    }
+
+    // must be called only from one (consumer) thread
+    bool try_pop(T& value) noexcept
+    {
+        Cell& cell = cells_[dequeue_pos_ & mask_];
+
+        if (cell.sequence.load(std::memory_order_acquire) != dequeue_pos_ + 1)
+            return false;
+
+        value = cell.value;
+        cell.sequence.store(dequeue_pos_ + mask_ + 1, std::memory_order_release);
+        ++dequeue_pos_;
+
+        return true;
+    }
+
+private:
+    static size_t checked_capacity(size_t capacity)
+    {
+        if (capacity == 0 || (capacity & (capacity - 1)) != 0)
+            throw std::invalid_argument("RingBuffer: capacity must be a power of 2");
+
+        return capacity;
+    }
+};
+
+/////////////////////////////////////////////////////////////////
+// Logger that never blocks a caller
+//
+// Records are pushed into a ring buffer and written by a background thread.
+// When the buffer is full a record is dropped and counted.
+//
+class AsyncLogger : public Logger
+{
+public:
+    enum class Format
+    {
+        binary, // raw LogRecord structs
+        text    // one compact line per record
+    };
+
+    explicit AsyncLogger(std::ostream& out, Format format = Format::binary, size_t capacity = 1 << 16)
+        : out_ {out}
+        , format_ {format}
+        , records_ {capacity}
+        , flusher_ {[this] { flush_loop(); }}
+    {
+    }
+
+    AsyncLogger(const AsyncLogger&) = delete;
+    AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+    ~AsyncLogger() override
+    {
+        done_.store(true, std::memory_order_release);
+        flusher_.join();
+    }
+
+    void log(LogEvent event, int gadget_id) override
+    {
+        const auto now = std::chrono::steady_clock::now().time_since_epoch();
+        const LogRecord record {std::chrono::duration_cast<std::chrono::nanoseconds>(now).count(), event, gadget_id};
+
+        if (!records_.try_push(record))
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    size_t dropped() const noexcept
+    {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+    size_t written() const noexcept
+    {
+        return written_.load(std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr size_t write_batch_size = 1024;
+
+    std::ostream& out_;
+    Format format_;
+    RingBuffer<LogRecord> records_;
+    std::atomic<bool> done_ {false};
+    std::atomic<size_t> dropped_ {0};
+    std::atomic<size_t> written_ {0};
+    std::thread flusher_;
+
+    void flush_loop()
+    {
+        std::vector<LogRecord> batch;
+        batch.reserve(write_batch_size);
+
+        while (true)
+        {
+            const bool done = done_.load(std::memory_order_acquire);
+
+            LogRecord record;
+            while (batch.size() < write_batch_size && records_.try_pop(record))
+                batch.push_back(record);
+
+            if (!batch.empty())
+            {
+                write(batch);
+                batch.clear();
+            }
+            else if (done)
+                break;
+            else
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+
+        out_.flush();
+    }
+
+    void write(const std::vector<LogRecord>& batch)
+    {
+        if (format_ == Format::binary)
+        {
+            out_.write(reinterpret_cast<const char*>(batch.data()), batch.size() * sizeof(LogRecord));
+        }
+        else
+        {
+            for (const LogRecord& record : batch)
+                out_ << record.timestamp_ns << ' ' << static_cast<uint32_t>(record.event) << ' ' << record.gadget_id << '\n';
+        }
+
+        written_.fetch_add(batch.size(), std::memory_order_relaxed);
+    }
+};
+
+#endif // LOGGER_HPP
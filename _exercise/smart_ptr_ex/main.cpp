@@ -1,11 +1,27 @@
+#include "logger.hpp"
+#include "object_pool.hpp"
+#include "result.hpp"
+#include "slot_map.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <exception>
+#include <fstream>
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <random>
 #include <stdexcept>
+#include <thread>
 #include <vector>
 
 using namespace std;
 
+enum class GadgetError
+{
+    crashed
+};
+
 class Gadget
 {
 public:
@@ -43,6 +59,12 @@ public:
         throw std::runtime_error("ERROR");
     }
 
+    Result<void, GadgetError> try_unsafe() noexcept
+    {
+        std::cout << "Using a gadget with id: " << id() << " - Ups... It crashed..." << '\n';
+        return make_unexpected(GadgetError::crashed);
+    }
+
 private:
     int id_;
 };
@@ -76,13 +98,31 @@ std::unique_ptr<Gadget> create_gadget(int arg)
     return std::make_unique<Gadget>(arg);
 }
 
+using GadgetPtr = PooledPtr<Gadget>;
+
+GadgetPtr create_pooled_gadget(int arg)
+{
+    return make_pooled<Gadget>(arg);
+}
+
+std::vector<GadgetPtr> create_many_pooled_gadgets(unsigned int size)
+{
+    std::vector<GadgetPtr> many_gadgets;
+    many_gadgets.reserve(size);
+
+    for (unsigned int i = 0; i < size; ++i)
+        many_gadgets.push_back(create_pooled_gadget(i));
+
+    return many_gadgets;
+}
+
 class Player
 {
     std::unique_ptr<Gadget> gadget_;
-    std::ostream* logger_;
+    Logger* logger_;
 
 public:
-    Player(std::unique_ptr<Gadget> g, std::ostream* logger = nullptr)
+    Player(std::unique_ptr<Gadget> g, Logger* logger = nullptr)
         : gadget_ {std::move(g)}
         , logger_ {logger}
     {
@@ -115,13 +155,13 @@ public:
     ~Player()
     {
         if (logger_)
-            *logger_ << "Destroing a gadget: " << gadget_->id() << std::endl;
+            logger_->log(LogEvent::gadget_destroyed, gadget_->id());
     }
 
     void play()
     {
         if (logger_)
-            *logger_ << "Player is using a gadget: " << gadget_->id() << std::endl;
+            logger_->log(LogEvent::gadget_used, gadget_->id());
 
         gadget_->use();
     }
@@ -138,7 +178,7 @@ void unsafe1() // TODO: poprawa z wykorzystaniem smart_ptr
     ptr_gdgt->unsafe();
 }
 
-void unsafe2() // TODO: poprawa z wykorzystaniem smart_ptr
+Result<void, GadgetError> unsafe2() // TODO: poprawa z wykorzystaniem smart_ptr
 {
     int size = 10;
 
@@ -146,7 +186,12 @@ void unsafe2() // TODO: poprawa z wykorzystaniem smart_ptr
     /* kod korzystający z buffer */
 
     for (int i = 0; i < size; ++i)
-        buffer[0].unsafe();
+    {
+        if (auto result = buffer[0].try_unsafe(); !result)
+            return result;
+    }
+
+    return {};
 }
 
 void unsafe3()
@@ -173,13 +218,313 @@ void unsafe3()
     my_gadgets[1]->unsafe();
 }
 
-int main()
+//////////////////////////////////////////////
+// allocation benchmark: std::make_unique<Gadget> vs. ObjectPool<Gadget>
+
+template <typename GadgetFactory>
+std::chrono::microseconds churn_gadgets(GadgetFactory create, size_t no_of_threads, size_t gadgets_per_thread)
+{
+    constexpr size_t batch = 64;
+
+    auto worker = [&] {
+        std::vector<decltype(create(0))> gadgets;
+        gadgets.reserve(batch);
+
+        for (size_t i = 0; i < gadgets_per_thread; i += batch)
+        {
+            for (size_t j = 0; j < batch; ++j)
+                gadgets.push_back(create(static_cast<int>(j)));
+            gadgets.clear();
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < no_of_threads; ++i)
+        threads.emplace_back(worker);
+    for (auto& thd : threads)
+        thd.join();
+
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+}
+
+void benchmark_gadget_allocation()
+{
+    constexpr size_t gadgets_per_thread = 4'000'000;
+
+    auto* cout_buffer = cout.rdbuf(nullptr); // Gadget logs in ctor & dtor
+
+    std::vector<std::pair<size_t, std::pair<std::chrono::microseconds, std::chrono::microseconds>>> results;
+    for (size_t no_of_threads : {1u, 2u, 4u, 8u})
+    {
+        auto heap_time = churn_gadgets([](int id) { return std::make_unique<Gadget>(id); }, no_of_threads, gadgets_per_thread);
+        auto pool_time = churn_gadgets([](int id) { return make_pooled<Gadget>(id); }, no_of_threads, gadgets_per_thread);
+        results.push_back({no_of_threads, {heap_time, pool_time}});
+    }
+
+    cout.rdbuf(cout_buffer);
+
+    for (const auto& [no_of_threads, times] : results)
+    {
+        cout << "threads: " << no_of_threads << "; gadgets per thread: " << gadgets_per_thread << "\n"
+             << "  std::make_unique<Gadget>: " << times.first.count() << " us\n"
+             << "  make_pooled<Gadget>:      " << times.second.count() << " us\n";
+    }
+}
+
+//////////////////////////////////////////////
+// logging benchmark: OStreamLogger vs. AsyncLogger
+
+std::chrono::microseconds log_events(Logger& logger, size_t no_of_threads, size_t events_per_thread)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < no_of_threads; ++i)
+        threads.emplace_back([&logger, events_per_thread] {
+            for (size_t j = 0; j < events_per_thread; ++j)
+                logger.log(LogEvent::gadget_used, static_cast<int>(j));
+        });
+    for (auto& thd : threads)
+        thd.join();
+
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+}
+
+// OStreamLogger is not thread-safe - shared by many threads it needs a lock
+class SynchronizedLogger : public Logger
+{
+    Logger& logger_;
+    std::mutex mtx_;
+
+public:
+    explicit SynchronizedLogger(Logger& logger)
+        : logger_ {logger}
+    {
+    }
+
+    void log(LogEvent event, int gadget_id) override
+    {
+        std::lock_guard<std::mutex> lk {mtx_};
+        logger_.log(event, gadget_id);
+    }
+};
+
+void benchmark_logging()
+{
+#ifdef _WIN32
+    const char* null_device = "NUL";
+#else
+    const char* null_device = "/dev/null";
+#endif
+
+    constexpr size_t events_per_thread = 200'000;
+
+    auto events_per_second = [](size_t events, std::chrono::microseconds time) {
+        return static_cast<double>(events) / time.count() * 1e6;
+    };
+
+    for (size_t no_of_threads : {1u, 2u, 4u})
+    {
+        const size_t no_of_events = no_of_threads * events_per_thread;
+
+        std::ofstream sync_log {null_device};
+        OStreamLogger sync_logger {sync_log};
+        SynchronizedLogger locked_logger {sync_logger};
+        auto sync_time = log_events(locked_logger, no_of_threads, events_per_thread);
+
+        std::ofstream async_log {null_device, std::ios::binary};
+        size_t dropped = 0;
+        std::chrono::microseconds async_time;
+        {
+            AsyncLogger async_logger {async_log, AsyncLogger::Format::binary, 1 << 20};
+            async_time = log_events(async_logger, no_of_threads, events_per_thread);
+            dropped = async_logger.dropped();
+        }
+
+        // dropped records are not logged - only accepted ones count
+        cout << "threads: " << no_of_threads << "; events: " << no_of_events << "\n"
+             << "  OStreamLogger + mutex: " << events_per_second(no_of_events, sync_time) << " events/s\n"
+             << "  AsyncLogger:           " << events_per_second(no_of_events - dropped, async_time) << " accepted events/s; dropped: " << dropped << "\n";
+    }
+}
+
+//////////////////////////////////////////////
+// storage benchmark: vector<unique_ptr<Gadget>> vs. SlotMap<Gadget>
+
+template <typename F>
+std::chrono::microseconds measure(F&& f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+}
+
+void benchmark_gadget_storage()
+{
+    constexpr int no_of_gadgets = 1'000'000;
+    constexpr int no_of_passes = 20;
+
+    auto* cout_buffer = cout.rdbuf(nullptr);
+
+    std::mt19937 rnd {665};
+
+    vector<std::unique_ptr<Gadget>> heap_gadgets;
+    SlotMap<Gadget> slot_gadgets;
+    std::vector<SlotMap<Gadget>::Handle> handles;
+
+    slot_gadgets.reserve(no_of_gadgets);
+    for (int i = 0; i < no_of_gadgets; ++i)
+    {
+        heap_gadgets.push_back(create_gadget(i));
+        handles.push_back(slot_gadgets.emplace(i));
+    }
+
+    // heap objects interleaved with other allocations - as in a long running process
+    std::shuffle(heap_gadgets.begin(), heap_gadgets.end(), rnd);
+
+    std::vector<size_t> lookups(no_of_gadgets);
+    for (auto& index : lookups)
+        index = rnd() % no_of_gadgets;
+
+    int64_t checksum = 0;
+
+    auto heap_iteration = measure([&] {
+        for (int pass = 0; pass < no_of_passes; ++pass)
+            for (auto& g : heap_gadgets)
+                g->set_id(g->id() + 1);
+    });
+
+    auto slot_iteration = measure([&] {
+        for (int pass = 0; pass < no_of_passes; ++pass)
+            for (auto& g : slot_gadgets)
+                g.set_id(g.id() + 1);
+    });
+
+    auto heap_lookup = measure([&] {
+        for (size_t index : lookups)
+            checksum += heap_gadgets[index]->id();
+    });
+
+    auto slot_lookup = measure([&] {
+        for (size_t index : lookups)
+            checksum += slot_gadgets[handles[index]].id();
+    });
+
+    cout.rdbuf(cout_buffer);
+
+    cout << "gadgets: " << no_of_gadgets << " (checksum: " << checksum << ")\n"
+         << "  iteration x" << no_of_passes << " - vector<unique_ptr<Gadget>>: " << heap_iteration.count() << " us\n"
+         << "  iteration x" << no_of_passes << " - SlotMap<Gadget>:            " << slot_iteration.count() << " us\n"
+         << "  random access - vector<unique_ptr<Gadget>>:  " << heap_lookup.count() << " us\n"
+         << "  random access - SlotMap<Gadget>:             " << slot_lookup.count() << " us\n";
+
+    cout.rdbuf(nullptr);
+    heap_gadgets.clear();
+    slot_gadgets = SlotMap<Gadget> {};
+    cout.rdbuf(cout_buffer);
+}
+
+//////////////////////////////////////////////
+// error path benchmark: throw/catch vs. Result
+
+void benchmark_error_handling()
+{
+    constexpr size_t no_of_calls = 1'000'000;
+
+    struct Measurement
+    {
+        double failure_rate;
+        size_t failures;
+        std::chrono::microseconds throw_time;
+        std::chrono::microseconds result_time;
+    };
+
+    std::vector<Measurement> measurements;
+    std::mt19937 rnd {42};
+
+    auto* cout_buffer = cout.rdbuf(nullptr);
+    auto g = std::make_unique<Gadget>(1);
+
+    // a call either uses a gadget (the same on both paths) or crashes it - unsafe() throws, try_unsafe() returns an error
+    for (double failure_rate : {0.0, 0.01, 0.1, 0.5, 1.0})
+    {
+        std::bernoulli_distribution fails {failure_rate};
+        std::vector<char> crashes(no_of_calls);
+        for (auto& crash : crashes)
+            crash = fails(rnd);
+
+        size_t throw_failures = 0;
+        auto throw_time = measure([&] {
+            for (size_t i = 0; i < no_of_calls; ++i)
+            {
+                try
+                {
+                    if (crashes[i])
+                        g->unsafe();
+                    else
+                        g->use();
+                }
+                catch (const std::runtime_error&)
+                {
+                    ++throw_failures;
+                }
+            }
+        });
+
+        size_t result_failures = 0;
+        auto result_time = measure([&] {
+            for (size_t i = 0; i < no_of_calls; ++i)
+            {
+                if (crashes[i])
+                {
+                    if (!g->try_unsafe())
+                        ++result_failures;
+                }
+                else
+                    g->use();
+            }
+        });
+
+        if (throw_failures != result_failures)
+            throw std::logic_error("benchmark_error_handling: both paths have to fail the same calls");
+
+        measurements.push_back(Measurement {failure_rate, result_failures, throw_time, result_time});
+    }
+
+    g.reset();
+    cout.rdbuf(cout_buffer);
+
+    for (const auto& [failure_rate, failures, throw_time, result_time] : measurements)
+    {
+        // extra cost of the throwing path spread over its failures
+        const double ns_per_failure = failures ? 1000.0 * (throw_time - result_time).count() / failures : 0.0;
+
+        cout << "calls: " << no_of_calls << "; failure rate: " << failure_rate * 100 << "%; failures: " << failures << "\n"
+             << "  unsafe() - throw/catch:  " << throw_time.count() << " us\n"
+             << "  try_unsafe() - Result:   " << result_time.count() << " us\n"
+             << "  cost of a throw: ~" << ns_per_failure << " ns\n";
+    }
+}
+
+int main(int argc, char* argv[])
 try
 {
+    if (argc > 1 && std::strcmp(argv[1], "--bench") == 0)
+    {
+        benchmark_gadget_allocation();
+        benchmark_logging();
+        benchmark_gadget_storage();
+        benchmark_error_handling();
+        return 0;
+    }
+
     try
     {
         //unsafe1();
-        //unsafe2();
+        //if (!unsafe2())
+        //    cout << "unsafe2 failed\n";
         unsafe3();
     }
     catch (const exception& e)
@@ -0,0 +1,217 @@
+#ifndef OBJECT_POOL_HPP
+#define OBJECT_POOL_HPP
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+/////////////////////////////////////////////////////////////////
+// ObjectPool - fixed-size slots for objects of type T
+//
+// Every thread keeps its own cache of free slots, so allocate/deallocate
+// does not touch a lock. The shared pool is locked only when a cache is
+// empty (refill with a batch of slots) or overflows (return a batch).
+// After a cache of a thread is destroyed (thread exit, destructors of
+// statics) slots go straight to the shared pool under the lock.
+//
+// The pool is never destroyed (PooledPtrs in statics may outlive any
+// static object) and its chunks are never returned to the heap - freed
+// slots are reused by the pool, the memory is reclaimed at process exit.
+//
+template <typename T>
+class ObjectPool
+{
+public:
+    static constexpr size_t chunk_size = 1024;       // slots allocated at once from the heap
+    static constexpr size_t thread_cache_size = 256; // max number of free slots cached by a thread
+    static constexpr size_t batch_size = thread_cache_size / 2;
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    static ObjectPool& instance()
+    {
+        static ObjectPool* pool = new ObjectPool; // intentionally leaked - see above
+        return *pool;
+    }
+
+    template <typename... Args>
+    T* create(Args&&... args)
+    {
+        void* slot = allocate();
+
+        try
+        {
+            return new (slot) T(std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            deallocate(slot);
+            throw;
+        }
+    }
+
+    void destroy(T* ptr) noexcept
+    {
+        if (ptr)
+        {
+            ptr->~T();
+            deallocate(ptr);
+        }
+    }
+
+private:
+    union Slot
+    {
+        Slot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    struct FreeList
+    {
+        Slot* head = nullptr;
+        size_t count = 0;
+
+        void push(Slot* slot) noexcept
+        {
+            slot->next = head;
+            head = slot;
+            ++count;
+        }
+
+        Slot* pop() noexcept
+        {
+            Slot* slot = head;
+            head = slot->next;
+            --count;
+            return slot;
+        }
+    };
+
+    struct ThreadCache
+    {
+        FreeList free_slots;
+
+        ~ThreadCache()
+        {
+            cache_destroyed_ = true;
+            ObjectPool::instance().release(free_slots, free_slots.count);
+        }
+    };
+
+    // trivially destructible - still readable when ThreadCache of a thread is already gone
+    static inline thread_local bool cache_destroyed_ = false;
+
+    std::mutex mtx_;
+    FreeList free_slots_;
+    std::vector<std::unique_ptr<Slot[]>> chunks_;
+
+    ObjectPool() = default;
+
+    static ThreadCache& thread_cache()
+    {
+        thread_local ThreadCache cache;
+        return cache;
+    }
+
+    void* allocate()
+    {
+        if (cache_destroyed_)
+            return allocate_shared();
+
+        FreeList& cache = thread_cache().free_slots;
+
+        if (cache.head == nullptr)
+            acquire(cache, batch_size);
+
+        return cache.pop()->storage;
+    }
+
+    void deallocate(void* ptr) noexcept
+    {
+        if (cache_destroyed_)
+            return deallocate_shared(ptr);
+
+        FreeList& cache = thread_cache().free_slots;
+
+        cache.push(static_cast<Slot*>(ptr));
+
+        if (cache.count > thread_cache_size)
+            release(cache, batch_size);
+    }
+
+    void* allocate_shared()
+    {
+        std::lock_guard<std::mutex> lk {mtx_};
+
+        if (free_slots_.head == nullptr)
+            add_chunk();
+
+        return free_slots_.pop()->storage;
+    }
+
+    void deallocate_shared(void* ptr) noexcept
+    {
+        std::lock_guard<std::mutex> lk {mtx_};
+
+        free_slots_.push(static_cast<Slot*>(ptr));
+    }
+
+    // moves n slots from the shared pool to a thread cache
+    void acquire(FreeList& cache, size_t n)
+    {
+        std::lock_guard<std::mutex> lk {mtx_};
+
+        if (free_slots_.count < n)
+            add_chunk();
+
+        for (size_t i = 0; i < n; ++i)
+            cache.push(free_slots_.pop());
+    }
+
+    // called with mtx_ locked
+    void add_chunk()
+    {
+        chunks_.push_back(std::make_unique<Slot[]>(chunk_size));
+        Slot* chunk = chunks_.back().get();
+
+        for (size_t i = 0; i < chunk_size; ++i)
+            free_slots_.push(&chunk[i]);
+    }
+
+    // moves n slots from a thread cache back to the shared pool
+    void release(FreeList& cache, size_t n) noexcept
+    {
+        std::lock_guard<std::mutex> lk {mtx_};
+
+        for (size_t i = 0; i < n; ++i)
+            free_slots_.push(cache.pop());
+    }
+};
+
+/////////////////////////////////////////////////////////////////
+// deleter returning an object to its pool - unique_ptr<T, PoolDeleter<T>>
+// has the same size as a raw pointer
+//
+template <typename T>
+struct PoolDeleter
+{
+    void operator()(T* ptr) const noexcept
+    {
+        ObjectPool<T>::instance().destroy(ptr);
+    }
+};
+
+template <typename T>
+using PooledPtr = std::unique_ptr<T, PoolDeleter<T>>;
+
+template <typename T, typename... Args>
+PooledPtr<T> make_pooled(Args&&... args)
+{
+    return PooledPtr<T>(ObjectPool<T>::instance().create(std::forward<Args>(args)...));
+}
+
+#endif // OBJECT_POOL_HPP
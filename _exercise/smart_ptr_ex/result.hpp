@@ -0,0 +1,119 @@
+#ifndef RESULT_HPP
+#define RESULT_HPP
+
+#include <cassert>
+#include <optional>
+#include <utility>
+#include <variant>
+
+/////////////////////////////////////////////////////////////////
+// Result<T, E> - value or error (in the spirit of C++23 std::expected)
+//
+// Errors are returned, not thrown - reporting a failure costs as much as
+// returning a value.
+//
+template <typename E>
+struct Unexpected
+{
+    E error;
+};
+
+template <typename E>
+Unexpected<E> make_unexpected(E error)
+{
+    return Unexpected<E> {std::move(error)};
+}
+
+template <typename T, typename E>
+class [[nodiscard]] Result
+{
+    std::variant<T, Unexpected<E>> storage_;
+
+public:
+    using value_type = T;
+    using error_type = E;
+
+    Result(const T& value)
+        : storage_ {std::in_place_index<0>, value}
+    {
+    }
+
+    Result(T&& value)
+        : storage_ {std::in_place_index<0>, std::move(value)}
+    {
+    }
+
+    Result(Unexpected<E> error)
+        : storage_ {std::in_place_index<1>, std::move(error)}
+    {
+    }
+
+    bool has_value() const noexcept
+    {
+        return storage_.index() == 0;
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return has_value();
+    }
+
+    T& value() noexcept
+    {
+        assert(has_value());
+        return *std::get_if<0>(&storage_);
+    }
+
+    const T& value() const noexcept
+    {
+        assert(has_value());
+        return *std::get_if<0>(&storage_);
+    }
+
+    template <typename U>
+    T value_or(U&& default_value) const
+    {
+        return has_value() ? value() : static_cast<T>(std::forward<U>(default_value));
+    }
+
+    const E& error() const noexcept
+    {
+        assert(!has_value());
+        return std::get_if<1>(&storage_)->error;
+    }
+};
+
+template <typename E>
+class [[nodiscard]] Result<void, E>
+{
+    std::optional<E> error_;
+
+public:
+    using value_type = void;
+    using error_type = E;
+
+    Result() = default;
+
+    Result(Unexpected<E> error)
+        : error_ {std::move(error.error)}
+    {
+    }
+
+    bool has_value() const noexcept
+    {
+        return !error_.has_value();
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return has_value();
+    }
+
+    const E& error() const noexcept
+    {
+        assert(!has_value());
+        return *error_;
+    }
+};
+
+#endif // RESULT_HPP
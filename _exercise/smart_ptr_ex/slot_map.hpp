@@ -0,0 +1,207 @@
+#ifndef SLOT_MAP_HPP
+#define SLOT_MAP_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/////////////////////////////////////////////////////////////////
+// SlotMap - objects stored contiguously, accessed by stable handles
+//
+// A handle points to a slot, a slot points to the position of an object in
+// the dense array. Erase moves the last object into the hole, so iteration
+// never skips gaps. A slot's generation is bumped on erase and on reuse, so
+// handles to removed objects are detected instead of silently aliasing a
+// new object. An odd generation marks a free slot - no handle (stale, from
+// another SlotMap or with a wrapped generation) ever reaches one.
+//
+template <typename T>
+class SlotMap
+{
+public:
+    struct Handle
+    {
+        uint32_t index;
+        uint32_t generation;
+
+        bool operator==(const Handle& other) const noexcept
+        {
+            return index == other.index && generation == other.generation;
+        }
+
+        bool operator!=(const Handle& other) const noexcept
+        {
+            return !(*this == other);
+        }
+    };
+
+    using value_type = T;
+    using iterator = typename std::vector<T>::iterator;
+    using const_iterator = typename std::vector<T>::const_iterator;
+
+    // strong guarantee - all allocations and the construction of a value
+    // happen before a slot is claimed, the rest cannot throw
+    template <typename... Args>
+    Handle emplace(Args&&... args)
+    {
+        grow_if_full(value_slots_);
+        if (free_head_ == no_free_slot)
+            grow_if_full(slots_);
+
+        values_.emplace_back(std::forward<Args>(args)...);
+
+        uint32_t slot_index;
+
+        if (free_head_ != no_free_slot)
+        {
+            slot_index = free_head_;
+            free_head_ = slots_[slot_index].position;
+            ++slots_[slot_index].generation; // odd (free) -> even (live)
+        }
+        else
+        {
+            slot_index = static_cast<uint32_t>(slots_.size());
+            slots_.push_back(Slot {0, 0}); // capacity reserved above
+        }
+
+        value_slots_.push_back(slot_index); // capacity reserved above
+
+        Slot& slot = slots_[slot_index];
+        slot.position = static_cast<uint32_t>(values_.size() - 1);
+
+        return Handle {slot_index, slot.generation};
+    }
+
+    Handle insert(const T& value)
+    {
+        return emplace(value);
+    }
+
+    Handle insert(T&& value)
+    {
+        return emplace(std::move(value));
+    }
+
+    bool erase(Handle handle)
+    {
+        if (!contains(handle))
+            return false;
+
+        Slot& slot = slots_[handle.index];
+        const uint32_t position = slot.position;
+        const uint32_t last = static_cast<uint32_t>(values_.size() - 1);
+
+        if (position != last)
+        {
+            values_[position] = std::move(values_[last]);
+            value_slots_[position] = value_slots_[last];
+            slots_[value_slots_[position]].position = position;
+        }
+
+        values_.pop_back();
+        value_slots_.pop_back();
+
+        ++slot.generation; // even (live) -> odd (free)
+        slot.position = free_head_;
+        free_head_ = handle.index;
+
+        return true;
+    }
+
+    bool contains(Handle handle) const noexcept
+    {
+        return handle.index < slots_.size() && is_live(slots_[handle.index]) && slots_[handle.index].generation == handle.generation;
+    }
+
+    // returns nullptr for stale handles
+    T* get(Handle handle) noexcept
+    {
+        return contains(handle) ? &values_[slots_[handle.index].position] : nullptr;
+    }
+
+    const T* get(Handle handle) const noexcept
+    {
+        return contains(handle) ? &values_[slots_[handle.index].position] : nullptr;
+    }
+
+    // handle must be valid
+    T& operator[](Handle handle) noexcept
+    {
+        assert(contains(handle));
+        return values_[slots_[handle.index].position];
+    }
+
+    const T& operator[](Handle handle) const noexcept
+    {
+        assert(contains(handle));
+        return values_[slots_[handle.index].position];
+    }
+
+    size_t size() const noexcept
+    {
+        return values_.size();
+    }
+
+    bool empty() const noexcept
+    {
+        return values_.empty();
+    }
+
+    void reserve(size_t capacity)
+    {
+        values_.reserve(capacity);
+        value_slots_.reserve(capacity);
+        slots_.reserve(capacity);
+    }
+
+    iterator begin() noexcept
+    {
+        return values_.begin();
+    }
+
+    iterator end() noexcept
+    {
+        return values_.end();
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return values_.begin();
+    }
+
+    const_iterator end() const noexcept
+    {
+        return values_.end();
+    }
+
+private:
+    static constexpr uint32_t no_free_slot = UINT32_MAX;
+
+    struct Slot
+    {
+        uint32_t position; // index in values_ or next free slot
+        uint32_t generation; // even - live, odd - free
+    };
+
+    static bool is_live(const Slot& slot) noexcept
+    {
+        return (slot.generation & 1) == 0;
+    }
+
+    template <typename TVector>
+    static void grow_if_full(TVector& items)
+    {
+        if (items.size() == items.capacity())
+            items.reserve(std::max<size_t>(2 * items.size(), 1));
+    }
+
+    std::vector<T> values_;
+    std::vector<uint32_t> value_slots_; // values_[i] is owned by slots_[value_slots_[i]]
+    std::vector<Slot> slots_;
+    uint32_t free_head_ = no_free_slot;
+};
+
+#endif // SLOT_MAP_HPP
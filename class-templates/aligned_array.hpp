@@ -0,0 +1,221 @@
+#ifndef ALIGNED_ARRAY_HPP
+#define ALIGNED_ARRAY_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <utility>
+
+namespace Detail
+{
+    // alignment of a vector register (AVX) - only for arrays big enough to fill one
+    template <typename T, size_t N>
+    constexpr size_t array_alignment = (sizeof(T) * N >= 32) ? std::max<size_t>(32, alignof(T)) : alignof(T);
+
+    // short arrays are unrolled at compile time, longer ones are left to the loop vectorizer
+    constexpr size_t unroll_limit = 16;
+
+    template <typename F, size_t... Is>
+    constexpr void unrolled_for(F&& f, std::index_sequence<Is...>)
+    {
+        (f(Is), ...);
+    }
+
+    template <size_t N, typename F>
+    constexpr void for_each_index(F&& f)
+    {
+        if constexpr (N <= unroll_limit)
+            unrolled_for(f, std::make_index_sequence<N>{});
+        else
+            for (size_t i = 0; i < N; ++i)
+                f(i);
+    }
+}
+
+/////////////////////////////////////////////////////////////////
+// Array<T, N> - fixed-size aggregate aligned for SIMD loads
+//
+// Element-wise arithmetic returns a new Array, reductions (sum, dot)
+// keep several independent accumulators - floating point additions are
+// not reassociated by the compiler, so a single accumulator would
+// never be vectorized.
+//
+template <typename T, size_t N>
+struct Array
+{
+    alignas(Detail::array_alignment<T, N>) T items[N];
+
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    static constexpr size_t size() noexcept
+    {
+        return N;
+    }
+
+    constexpr T& operator[](size_t index) noexcept
+    {
+        return items[index];
+    }
+
+    constexpr const T& operator[](size_t index) const noexcept
+    {
+        return items[index];
+    }
+
+    constexpr T* data() noexcept
+    {
+        return items;
+    }
+
+    constexpr const T* data() const noexcept
+    {
+        return items;
+    }
+
+    constexpr T* begin() noexcept
+    {
+        return items;
+    }
+
+    constexpr T* end() noexcept
+    {
+        return items + N;
+    }
+
+    constexpr const T* begin() const noexcept
+    {
+        return items;
+    }
+
+    constexpr const T* end() const noexcept
+    {
+        return items + N;
+    }
+
+    constexpr void fill(const T& value)
+    {
+        Detail::for_each_index<N>([&](size_t i) { items[i] = value; });
+    }
+
+    constexpr Array& operator+=(const Array& other)
+    {
+        Detail::for_each_index<N>([&](size_t i) { items[i] += other.items[i]; });
+        return *this;
+    }
+
+    constexpr Array& operator-=(const Array& other)
+    {
+        Detail::for_each_index<N>([&](size_t i) { items[i] -= other.items[i]; });
+        return *this;
+    }
+
+    constexpr Array& operator*=(const Array& other)
+    {
+        Detail::for_each_index<N>([&](size_t i) { items[i] *= other.items[i]; });
+        return *this;
+    }
+
+    constexpr Array& operator*=(const T& factor)
+    {
+        Detail::for_each_index<N>([&](size_t i) { items[i] *= factor; });
+        return *this;
+    }
+
+    friend constexpr bool operator==(const Array& a, const Array& b)
+    {
+        for (size_t i = 0; i < N; ++i)
+            if (a.items[i] != b.items[i])
+                return false;
+
+        return true;
+    }
+
+    friend constexpr bool operator!=(const Array& a, const Array& b)
+    {
+        return !(a == b);
+    }
+};
+
+template <typename T, size_t N, typename F>
+constexpr Array<T, N> transform(const Array<T, N>& a, const Array<T, N>& b, F op)
+{
+    Array<T, N> result {};
+    Detail::for_each_index<N>([&](size_t i) { result.items[i] = op(a.items[i], b.items[i]); });
+    return result;
+}
+
+template <typename T, size_t N>
+constexpr Array<T, N> operator+(const Array<T, N>& a, const Array<T, N>& b)
+{
+    return transform(a, b, std::plus<> {});
+}
+
+template <typename T, size_t N>
+constexpr Array<T, N> operator-(const Array<T, N>& a, const Array<T, N>& b)
+{
+    return transform(a, b, std::minus<> {});
+}
+
+template <typename T, size_t N>
+constexpr Array<T, N> operator*(const Array<T, N>& a, const Array<T, N>& b)
+{
+    return transform(a, b, std::multiplies<> {});
+}
+
+template <typename T, size_t N>
+constexpr Array<T, N> operator*(Array<T, N> a, const T& factor)
+{
+    return a *= factor;
+}
+
+template <typename T, size_t N>
+constexpr Array<T, N> operator*(const T& factor, Array<T, N> a)
+{
+    return a *= factor;
+}
+
+// a * b + c in one pass - chained operators materialize a temporary Array for a * b
+template <typename T, size_t N>
+constexpr Array<T, N> multiply_add(const Array<T, N>& a, const Array<T, N>& b, const Array<T, N>& c)
+{
+    Array<T, N> result {};
+    Detail::for_each_index<N>([&](size_t i) { result.items[i] = a.items[i] * b.items[i] + c.items[i]; });
+    return result;
+}
+
+namespace Detail
+{
+    // sum of term(i) for i in [0, N) - lanes are combined pairwise, so a result does not depend on a compiler
+    template <typename T, size_t N, typename F>
+    constexpr T reduce(F term)
+    {
+        constexpr size_t lanes = 8;
+
+        T acc[lanes] = {};
+        size_t i = 0;
+        for (; i + lanes <= N; i += lanes)
+            for (size_t lane = 0; lane < lanes; ++lane)
+                acc[lane] += term(i + lane);
+
+        for (size_t lane = 0; lane < N % lanes; ++lane)
+            acc[lane] += term(i + lane);
+
+        return ((acc[0] + acc[1]) + (acc[2] + acc[3])) + ((acc[4] + acc[5]) + (acc[6] + acc[7]));
+    }
+}
+
+template <typename T, size_t N>
+constexpr T sum(const Array<T, N>& a)
+{
+    return Detail::reduce<T, N>([&](size_t i) { return a.items[i]; });
+}
+
+template <typename T, size_t N>
+constexpr T dot(const Array<T, N>& a, const Array<T, N>& b)
+{
+    return Detail::reduce<T, N>([&](size_t i) { return a.items[i] * b.items[i]; });
+}
+
+#endif // ALIGNED_ARRAY_HPP
@@ -0,0 +1,653 @@
+#ifndef DYNAMIC_BITSET_HPP
+#define DYNAMIC_BITSET_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define DYNAMIC_BITSET_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(DYNAMIC_BITSET_X86) && (defined(__GNUC__) || defined(__clang__))
+#define DYNAMIC_BITSET_AVX2 1
+#define DYNAMIC_BITSET_TARGET_AVX2 __attribute__((target("avx2")))
+#define DYNAMIC_BITSET_TARGET_POPCNT __attribute__((target("popcnt")))
+#endif
+
+namespace Detail
+{
+    /////////////////////////////////////////////////////////////////
+    // word kernels of DynamicBitset
+    //
+    // AVX2 & POPCNT versions are compiled with a function target attribute
+    // and selected at runtime - the binary still runs on plain x86-64.
+    // Without POPCNT __builtin_popcountll is a library call, not an instruction.
+    //
+    namespace Bits
+    {
+        using Word = uint64_t;
+
+        struct CpuFeatures
+        {
+            bool avx2 = false;
+            bool popcnt = false;
+        };
+
+        inline const CpuFeatures& cpu_features()
+        {
+            static const CpuFeatures features = [] {
+                CpuFeatures result;
+#ifdef DYNAMIC_BITSET_AVX2
+                __builtin_cpu_init();
+                result.avx2 = __builtin_cpu_supports("avx2");
+                result.popcnt = __builtin_cpu_supports("popcnt");
+#endif
+                return result;
+            }();
+
+            return features;
+        }
+
+        inline unsigned lowest_bit(Word word) noexcept
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return static_cast<unsigned>(__builtin_ctzll(word));
+#else
+            unsigned result = 0;
+            while ((word & 1) == 0)
+            {
+                word >>= 1;
+                ++result;
+            }
+            return result;
+#endif
+        }
+
+        inline size_t popcount(Word word) noexcept
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return static_cast<size_t>(__builtin_popcountll(word));
+#else
+            size_t result = 0;
+            for (; word != 0; word &= word - 1)
+                ++result;
+            return result;
+#endif
+        }
+
+        struct And
+        {
+            static Word apply(Word a, Word b) noexcept
+            {
+                return a & b;
+            }
+
+#ifdef DYNAMIC_BITSET_AVX2
+            DYNAMIC_BITSET_TARGET_AVX2 static __m256i apply(__m256i a, __m256i b) noexcept
+            {
+                return _mm256_and_si256(a, b);
+            }
+#endif
+        };
+
+        struct Or
+        {
+            static Word apply(Word a, Word b) noexcept
+            {
+                return a | b;
+            }
+
+#ifdef DYNAMIC_BITSET_AVX2
+            DYNAMIC_BITSET_TARGET_AVX2 static __m256i apply(__m256i a, __m256i b) noexcept
+            {
+                return _mm256_or_si256(a, b);
+            }
+#endif
+        };
+
+        struct Xor
+        {
+            static Word apply(Word a, Word b) noexcept
+            {
+                return a ^ b;
+            }
+
+#ifdef DYNAMIC_BITSET_AVX2
+            DYNAMIC_BITSET_TARGET_AVX2 static __m256i apply(__m256i a, __m256i b) noexcept
+            {
+                return _mm256_xor_si256(a, b);
+            }
+#endif
+        };
+
+        // a & ~b
+        struct AndNot
+        {
+            static Word apply(Word a, Word b) noexcept
+            {
+                return a & ~b;
+            }
+
+#ifdef DYNAMIC_BITSET_AVX2
+            DYNAMIC_BITSET_TARGET_AVX2 static __m256i apply(__m256i a, __m256i b) noexcept
+            {
+                return _mm256_andnot_si256(b, a);
+            }
+#endif
+        };
+
+        template <typename TOp>
+        void combine_portable(Word* dest, const Word* source, size_t size) noexcept
+        {
+            for (size_t i = 0; i < size; ++i)
+                dest[i] = TOp::apply(dest[i], source[i]);
+        }
+
+        inline size_t count_portable(const Word* words, size_t size) noexcept
+        {
+            size_t result = 0;
+            for (size_t i = 0; i < size; ++i)
+                result += popcount(words[i]);
+            return result;
+        }
+
+        inline size_t first_nonzero_portable(const Word* words, size_t first, size_t size) noexcept
+        {
+            while (first < size && words[first] == 0)
+                ++first;
+            return first;
+        }
+
+#ifdef DYNAMIC_BITSET_AVX2
+        template <typename TOp>
+        DYNAMIC_BITSET_TARGET_AVX2 void combine_avx2(Word* dest, const Word* source, size_t size) noexcept
+        {
+            size_t i = 0;
+            for (; i + 4 <= size; i += 4)
+            {
+                const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dest + i));
+                const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + i), TOp::apply(a, b));
+            }
+
+            for (; i < size; ++i)
+                dest[i] = TOp::apply(dest[i], source[i]);
+        }
+
+        DYNAMIC_BITSET_TARGET_POPCNT inline size_t count_popcnt(const Word* words, size_t size) noexcept
+        {
+            size_t result = 0;
+            for (size_t i = 0; i < size; ++i)
+                result += static_cast<size_t>(__builtin_popcountll(words[i]));
+            return result;
+        }
+
+        // bit counts of nibbles looked up with vpshufb, summed per 64-bit lane with vpsadbw
+        DYNAMIC_BITSET_TARGET_AVX2 inline size_t count_avx2(const Word* words, size_t size) noexcept
+        {
+            const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+            const __m256i low_nibbles = _mm256_set1_epi8(0x0f);
+            __m256i totals = _mm256_setzero_si256();
+
+            size_t i = 0;
+            while (i + 4 <= size)
+            {
+                // byte counters take at most 31 vectors (31 * 8 bits) before they are widened
+                __m256i byte_counts = _mm256_setzero_si256();
+                for (size_t block_end = std::min(size - size % 4, i + 4 * 31); i < block_end; i += 4)
+                {
+                    const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + i));
+                    const __m256i low = _mm256_shuffle_epi8(lookup, _mm256_and_si256(v, low_nibbles));
+                    const __m256i high = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(v, 4), low_nibbles));
+                    byte_counts = _mm256_add_epi8(byte_counts, _mm256_add_epi8(low, high));
+                }
+
+                totals = _mm256_add_epi64(totals, _mm256_sad_epu8(byte_counts, _mm256_setzero_si256()));
+            }
+
+            size_t result = static_cast<size_t>(_mm256_extract_epi64(totals, 0) + _mm256_extract_epi64(totals, 1)
+                + _mm256_extract_epi64(totals, 2) + _mm256_extract_epi64(totals, 3));
+
+            for (; i < size; ++i)
+                result += popcount(words[i]);
+
+            return result;
+        }
+
+        // skips 4 zero words per test
+        DYNAMIC_BITSET_TARGET_AVX2 inline size_t first_nonzero_avx2(const Word* words, size_t first, size_t size) noexcept
+        {
+            for (; first + 4 <= size; first += 4)
+            {
+                const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + first));
+                if (!_mm256_testz_si256(v, v))
+                    break;
+            }
+
+            return first_nonzero_portable(words, first, size);
+        }
+#endif
+
+        template <typename TOp>
+        void combine(Word* dest, const Word* source, size_t size) noexcept
+        {
+#ifdef DYNAMIC_BITSET_AVX2
+            if (cpu_features().avx2)
+                return combine_avx2<TOp>(dest, source, size);
+#endif
+            combine_portable<TOp>(dest, source, size);
+        }
+
+        inline size_t count(const Word* words, size_t size) noexcept
+        {
+#ifdef DYNAMIC_BITSET_AVX2
+            if (cpu_features().avx2)
+                return count_avx2(words, size);
+            if (cpu_features().popcnt)
+                return count_popcnt(words, size);
+#endif
+            return count_portable(words, size);
+        }
+
+        inline size_t first_nonzero(const Word* words, size_t first, size_t size) noexcept
+        {
+            // a nearby set bit is the common case - check a few words before a dispatch
+            for (const size_t scalar_end = std::min(first + 2, size); first < scalar_end; ++first)
+                if (words[first] != 0)
+                    return first;
+
+#ifdef DYNAMIC_BITSET_AVX2
+            if (cpu_features().avx2)
+                return first_nonzero_avx2(words, first, size);
+#endif
+            return first_nonzero_portable(words, first, size);
+        }
+    }
+}
+
+/////////////////////////////////////////////////////////////////
+// DynamicBitset<TAllocator> - runtime sized std::bitset
+//
+// A replacement for std::vector<bool> flags: bits are packed into 64-bit
+// words and whole-set operations (&=, |=, ^=, -=, count, find_next) work
+// on words - four at a time with AVX2 when a CPU has it. Set bits are
+// visited with set_bits() (or find_first/find_next) skipping zero words.
+// Bits after size() in the last word are always zero.
+//
+template <typename TAllocator = std::allocator<uint64_t>>
+class DynamicBitset
+{
+    using Word = Detail::Bits::Word;
+
+    static constexpr size_t word_bits = 64;
+
+    std::vector<Word, TAllocator> words_;
+    size_t size_ = 0;
+
+public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    class Reference
+    {
+        DynamicBitset& bitset_;
+        size_t index_;
+
+    public:
+        Reference(DynamicBitset& bitset, size_t index) noexcept
+            : bitset_ {bitset}
+            , index_ {index}
+        {
+        }
+
+        operator bool() const noexcept
+        {
+            return bitset_.test(index_);
+        }
+
+        Reference& operator=(bool value) noexcept
+        {
+            bitset_.set(index_, value);
+            return *this;
+        }
+
+        Reference& operator=(const Reference& other) noexcept
+        {
+            return *this = static_cast<bool>(other);
+        }
+
+        Reference& flip() noexcept
+        {
+            bitset_.flip(index_);
+            return *this;
+        }
+    };
+
+    // indexes of set bits in increasing order
+    class SetBitIterator
+    {
+        const DynamicBitset* bitset_;
+        size_t word_index_;
+        Word word_; // bits of a current word not visited yet
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = size_t;
+
+        SetBitIterator(const DynamicBitset* bitset, size_t word_index) noexcept
+            : bitset_ {bitset}
+            , word_index_ {word_index}
+            , word_ {word_index < bitset->words_.size() ? bitset->words_[word_index] : 0}
+        {
+            skip_zero_words();
+        }
+
+        size_t operator*() const noexcept
+        {
+            return word_index_ * word_bits + Detail::Bits::lowest_bit(word_);
+        }
+
+        SetBitIterator& operator++() noexcept
+        {
+            word_ &= word_ - 1;
+            skip_zero_words();
+            return *this;
+        }
+
+        SetBitIterator operator++(int) noexcept
+        {
+            SetBitIterator result = *this;
+            ++*this;
+            return result;
+        }
+
+        bool operator==(const SetBitIterator& other) const noexcept
+        {
+            return word_index_ == other.word_index_ && word_ == other.word_;
+        }
+
+        bool operator!=(const SetBitIterator& other) const noexcept
+        {
+            return !(*this == other);
+        }
+
+    private:
+        void skip_zero_words() noexcept
+        {
+            const auto& words = bitset_->words_;
+            if (word_ != 0 || word_index_ >= words.size())
+                return;
+
+            word_index_ = Detail::Bits::first_nonzero(words.data(), word_index_ + 1, words.size());
+            word_ = word_index_ < words.size() ? words[word_index_] : 0;
+        }
+    };
+
+    struct SetBits
+    {
+        const DynamicBitset* bitset;
+
+        SetBitIterator begin() const noexcept
+        {
+            return SetBitIterator {bitset, 0};
+        }
+
+        SetBitIterator end() const noexcept
+        {
+            return SetBitIterator {bitset, bitset->words_.size()};
+        }
+    };
+
+    DynamicBitset() = default;
+
+    explicit DynamicBitset(size_t size, bool value = false, const TAllocator& allocator = TAllocator {})
+        : words_(words_for(size), value ? ~Word {0} : Word {0}, allocator)
+        , size_ {size}
+    {
+        clear_unused_bits();
+    }
+
+    size_t size() const noexcept
+    {
+        return size_;
+    }
+
+    bool empty() const noexcept
+    {
+        return size_ == 0;
+    }
+
+    const Word* data() const noexcept
+    {
+        return words_.data();
+    }
+
+    size_t word_count() const noexcept
+    {
+        return words_.size();
+    }
+
+    bool test(size_t index) const noexcept
+    {
+        assert(index < size_);
+        return (words_[index / word_bits] >> (index % word_bits)) & 1;
+    }
+
+    bool operator[](size_t index) const noexcept
+    {
+        return test(index);
+    }
+
+    Reference operator[](size_t index) noexcept
+    {
+        return Reference {*this, index};
+    }
+
+    DynamicBitset& set(size_t index, bool value = true) noexcept
+    {
+        assert(index < size_);
+
+        Word& word = words_[index / word_bits];
+        const Word mask = Word {1} << (index % word_bits);
+        word = value ? (word | mask) : (word & ~mask);
+        return *this;
+    }
+
+    DynamicBitset& reset(size_t index) noexcept
+    {
+        return set(index, false);
+    }
+
+    DynamicBitset& flip(size_t index) noexcept
+    {
+        assert(index < size_);
+
+        words_[index / word_bits] ^= Word {1} << (index % word_bits);
+        return *this;
+    }
+
+    DynamicBitset& set() noexcept
+    {
+        std::fill(words_.begin(), words_.end(), ~Word {0});
+        clear_unused_bits();
+        return *this;
+    }
+
+    DynamicBitset& reset() noexcept
+    {
+        std::fill(words_.begin(), words_.end(), Word {0});
+        return *this;
+    }
+
+    DynamicBitset& flip() noexcept
+    {
+        for (Word& word : words_)
+            word = ~word;
+        clear_unused_bits();
+        return *this;
+    }
+
+    void push_back(bool value)
+    {
+        if (size_ % word_bits == 0)
+            words_.push_back(0);
+
+        ++size_;
+        set(size_ - 1, value);
+    }
+
+    void resize(size_t size, bool value = false)
+    {
+        const size_t old_size = size_;
+
+        words_.resize(words_for(size), value ? ~Word {0} : Word {0});
+        size_ = size;
+
+        if (value && old_size % word_bits != 0 && old_size < size)
+            words_[old_size / word_bits] |= ~Word {0} << (old_size % word_bits);
+
+        clear_unused_bits();
+    }
+
+    size_t count() const noexcept
+    {
+        return Detail::Bits::count(words_.data(), words_.size());
+    }
+
+    bool any() const noexcept
+    {
+        return find_first() != npos;
+    }
+
+    bool none() const noexcept
+    {
+        return !any();
+    }
+
+    bool all() const noexcept
+    {
+        return count() == size_;
+    }
+
+    size_t find_first() const noexcept
+    {
+        return find_from_word(0);
+    }
+
+    // the first set bit after index
+    size_t find_next(size_t index) const noexcept
+    {
+        const size_t next = index + 1;
+        if (next >= size_)
+            return npos;
+
+        const size_t word_index = next / word_bits;
+        const Word rest = words_[word_index] >> (next % word_bits);
+        if (rest != 0)
+            return next + Detail::Bits::lowest_bit(rest);
+
+        return find_from_word(word_index + 1);
+    }
+
+    SetBits set_bits() const noexcept
+    {
+        return SetBits {this};
+    }
+
+    DynamicBitset& operator&=(const DynamicBitset& other) noexcept
+    {
+        return combine<Detail::Bits::And>(other);
+    }
+
+    DynamicBitset& operator|=(const DynamicBitset& other) noexcept
+    {
+        return combine<Detail::Bits::Or>(other);
+    }
+
+    DynamicBitset& operator^=(const DynamicBitset& other) noexcept
+    {
+        return combine<Detail::Bits::Xor>(other);
+    }
+
+    // set difference - clears bits set in other
+    DynamicBitset& operator-=(const DynamicBitset& other) noexcept
+    {
+        return combine<Detail::Bits::AndNot>(other);
+    }
+
+    friend DynamicBitset operator&(DynamicBitset a, const DynamicBitset& b)
+    {
+        a &= b;
+        return a; // moved - return a &= b would copy the words
+    }
+
+    friend DynamicBitset operator|(DynamicBitset a, const DynamicBitset& b)
+    {
+        a |= b;
+        return a;
+    }
+
+    friend DynamicBitset operator^(DynamicBitset a, const DynamicBitset& b)
+    {
+        a ^= b;
+        return a;
+    }
+
+    friend DynamicBitset operator-(DynamicBitset a, const DynamicBitset& b)
+    {
+        a -= b;
+        return a;
+    }
+
+    friend bool operator==(const DynamicBitset& a, const DynamicBitset& b) noexcept
+    {
+        return a.size_ == b.size_ && a.words_ == b.words_;
+    }
+
+    friend bool operator!=(const DynamicBitset& a, const DynamicBitset& b) noexcept
+    {
+        return !(a == b);
+    }
+
+private:
+    static size_t words_for(size_t size) noexcept
+    {
+        return (size + word_bits - 1) / word_bits;
+    }
+
+    template <typename TOp>
+    DynamicBitset& combine(const DynamicBitset& other) noexcept
+    {
+        assert(size_ == other.size_ && "bitsets of different sizes");
+
+        Detail::Bits::combine<TOp>(words_.data(), other.words_.data(), words_.size());
+        return *this;
+    }
+
+    size_t find_from_word(size_t word_index) const noexcept
+    {
+        word_index = Detail::Bits::first_nonzero(words_.data(), word_index, words_.size());
+        if (word_index == words_.size())
+            return npos;
+
+        return word_index * word_bits + Detail::Bits::lowest_bit(words_[word_index]);
+    }
+
+    void clear_unused_bits() noexcept
+    {
+        const size_t used = size_ % word_bits;
+        if (used != 0)
+            words_.back() &= (Word {1} << used) - 1;
+    }
+};
+
+#endif // DYNAMIC_BITSET_HPP
@@ -0,0 +1,405 @@
+#ifndef FLAT_MAP_HPP
+#define FLAT_MAP_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+/////////////////////////////////////////////////////////////////
+// FlatMap<K, V, Compare> - sorted map in two contiguous vectors
+//
+// Keys and values are kept in separate sorted vectors: a binary search
+// touches only keys, iteration is a linear scan of memory. Lookup is
+// heterogeneous with a transparent Compare (std::less<> - e.g. find a
+// std::string key by std::string_view without a temporary string).
+//
+// Inserting & erasing single keys is O(n) - build big maps in bulk from
+// unsorted input (constructor from a range): O(n log n).
+//
+// There is no stored pair to reference - iterators yield a proxy
+// pair<const K&, V&> by value. Bind rows with auto or const auto&:
+//
+//   for (auto [key, value] : map)   // value is V& - assignable
+//       value *= 2;
+//
+// for (auto& [key, value] : map) does not compile.
+//
+template <typename K, typename V, typename Compare = std::less<>>
+class FlatMap
+{
+    std::vector<K> keys_;
+    std::vector<V> values_;
+    Compare compare_;
+
+    template <bool IsConst>
+    class Iterator
+    {
+        using Map = std::conditional_t<IsConst, const FlatMap, FlatMap>;
+        using Value = std::conditional_t<IsConst, const V, V>;
+
+        Map* map_;
+        size_t index_;
+
+        friend class FlatMap;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = std::pair<K, V>;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::pair<const K&, Value&>;
+
+        struct pointer
+        {
+            reference ref;
+
+            const reference* operator->() const noexcept
+            {
+                return &ref;
+            }
+        };
+
+        Iterator(Map* map, size_t index) noexcept
+            : map_ {map}
+            , index_ {index}
+        {
+        }
+
+        // iterator -> const_iterator
+        template <bool C = IsConst, typename = std::enable_if_t<C>>
+        Iterator(const Iterator<false>& other) noexcept
+            : map_ {other.map_}
+            , index_ {other.index_}
+        {
+        }
+
+        reference operator*() const noexcept
+        {
+            return reference {map_->keys_[index_], map_->values_[index_]};
+        }
+
+        pointer operator->() const noexcept
+        {
+            return pointer {**this};
+        }
+
+        Iterator& operator++() noexcept
+        {
+            ++index_;
+            return *this;
+        }
+
+        Iterator operator++(int) noexcept
+        {
+            Iterator result = *this;
+            ++index_;
+            return result;
+        }
+
+        Iterator& operator--() noexcept
+        {
+            --index_;
+            return *this;
+        }
+
+        Iterator operator--(int) noexcept
+        {
+            Iterator result = *this;
+            --index_;
+            return result;
+        }
+
+        Iterator& operator+=(difference_type n) noexcept
+        {
+            index_ += n;
+            return *this;
+        }
+
+        Iterator& operator-=(difference_type n) noexcept
+        {
+            index_ -= n;
+            return *this;
+        }
+
+        reference operator[](difference_type n) const noexcept
+        {
+            return *(*this + n);
+        }
+
+        friend Iterator operator+(Iterator it, difference_type n) noexcept
+        {
+            return it += n;
+        }
+
+        friend Iterator operator+(difference_type n, Iterator it) noexcept
+        {
+            return it += n;
+        }
+
+        friend Iterator operator-(Iterator it, difference_type n) noexcept
+        {
+            return it -= n;
+        }
+
+        friend difference_type operator-(const Iterator& a, const Iterator& b) noexcept
+        {
+            return static_cast<difference_type>(a.index_) - static_cast<difference_type>(b.index_);
+        }
+
+        friend bool operator==(const Iterator& a, const Iterator& b) noexcept
+        {
+            return a.index_ == b.index_;
+        }
+
+        friend bool operator!=(const Iterator& a, const Iterator& b) noexcept
+        {
+            return a.index_ != b.index_;
+        }
+
+        friend bool operator<(const Iterator& a, const Iterator& b) noexcept
+        {
+            return a.index_ < b.index_;
+        }
+
+        friend bool operator>(const Iterator& a, const Iterator& b) noexcept
+        {
+            return b < a;
+        }
+
+        friend bool operator<=(const Iterator& a, const Iterator& b) noexcept
+        {
+            return !(b < a);
+        }
+
+        friend bool operator>=(const Iterator& a, const Iterator& b) noexcept
+        {
+            return !(a < b);
+        }
+
+        template <bool>
+        friend class Iterator;
+    };
+
+public:
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = std::pair<K, V>;
+    using key_compare = Compare;
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    FlatMap() = default;
+
+    // bulk build - sorted once; for duplicated keys the first one wins (like std::map)
+    template <typename TIterator>
+    FlatMap(TIterator first, TIterator last, Compare compare = Compare {})
+        : compare_ {compare}
+    {
+        std::vector<value_type> items(first, last);
+        std::stable_sort(items.begin(), items.end(), [this](const auto& a, const auto& b) { return compare_(a.first, b.first); });
+
+        keys_.reserve(items.size());
+        values_.reserve(items.size());
+        for (auto& [key, value] : items)
+        {
+            if (!keys_.empty() && !compare_(keys_.back(), key))
+                continue;
+
+            keys_.push_back(std::move(key));
+            values_.push_back(std::move(value));
+        }
+    }
+
+    FlatMap(std::initializer_list<value_type> items, Compare compare = Compare {})
+        : FlatMap(items.begin(), items.end(), compare)
+    {
+    }
+
+    size_t size() const noexcept
+    {
+        return keys_.size();
+    }
+
+    bool empty() const noexcept
+    {
+        return keys_.empty();
+    }
+
+    void reserve(size_t capacity)
+    {
+        keys_.reserve(capacity);
+        values_.reserve(capacity);
+    }
+
+    void clear() noexcept
+    {
+        keys_.clear();
+        values_.clear();
+    }
+
+    const std::vector<K>& keys() const noexcept
+    {
+        return keys_;
+    }
+
+    const std::vector<V>& values() const noexcept
+    {
+        return values_;
+    }
+
+    iterator begin() noexcept
+    {
+        return iterator {this, 0};
+    }
+
+    iterator end() noexcept
+    {
+        return iterator {this, size()};
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return const_iterator {this, 0};
+    }
+
+    const_iterator end() const noexcept
+    {
+        return const_iterator {this, size()};
+    }
+
+    template <typename Q>
+    iterator lower_bound(const Q& key)
+    {
+        return iterator {this, lower_bound_index(key)};
+    }
+
+    template <typename Q>
+    const_iterator lower_bound(const Q& key) const
+    {
+        return const_iterator {this, lower_bound_index(key)};
+    }
+
+    template <typename Q>
+    iterator find(const Q& key)
+    {
+        return iterator {this, find_index(key)};
+    }
+
+    template <typename Q>
+    const_iterator find(const Q& key) const
+    {
+        return const_iterator {this, find_index(key)};
+    }
+
+    template <typename Q>
+    bool contains(const Q& key) const
+    {
+        return find_index(key) != size();
+    }
+
+    template <typename Q>
+    size_t count(const Q& key) const
+    {
+        return contains(key) ? 1 : 0;
+    }
+
+    template <typename Q>
+    V& at(const Q& key)
+    {
+        return values_[checked_index(key)];
+    }
+
+    template <typename Q>
+    const V& at(const Q& key) const
+    {
+        return values_[checked_index(key)];
+    }
+
+    V& operator[](const K& key)
+    {
+        return try_emplace(key).first->second;
+    }
+
+    template <typename... TArgs>
+    std::pair<iterator, bool> try_emplace(const K& key, TArgs&&... args)
+    {
+        const size_t index = lower_bound_index(key);
+        if (index != size() && !compare_(key, keys_[index]))
+            return {iterator {this, index}, false};
+
+        keys_.insert(keys_.begin() + index, key);
+        try
+        {
+            values_.emplace(values_.begin() + index, std::forward<TArgs>(args)...);
+        }
+        catch (...)
+        {
+            keys_.erase(keys_.begin() + index); // keys & values stay aligned
+            throw;
+        }
+
+        return {iterator {this, index}, true};
+    }
+
+    std::pair<iterator, bool> insert(const value_type& item)
+    {
+        return try_emplace(item.first, item.second);
+    }
+
+    template <typename TValue>
+    std::pair<iterator, bool> insert_or_assign(const K& key, TValue&& value)
+    {
+        auto result = try_emplace(key, std::forward<TValue>(value));
+        if (!result.second)
+            values_[result.first.index_] = std::forward<TValue>(value);
+
+        return result;
+    }
+
+    template <typename Q>
+    size_t erase(const Q& key)
+    {
+        const size_t index = find_index(key);
+        if (index == size())
+            return 0;
+
+        keys_.erase(keys_.begin() + index);
+        values_.erase(values_.begin() + index);
+        return 1;
+    }
+
+private:
+    template <typename Q>
+    size_t lower_bound_index(const Q& key) const
+    {
+        return static_cast<size_t>(std::lower_bound(keys_.begin(), keys_.end(), key, compare_) - keys_.begin());
+    }
+
+    template <typename Q>
+    size_t find_index(const Q& key) const
+    {
+        const size_t index = lower_bound_index(key);
+        return (index != size() && !compare_(key, keys_[index])) ? index : size();
+    }
+
+    template <typename Q>
+    size_t checked_index(const Q& key) const
+    {
+        const size_t index = find_index(key);
+        if (index == size())
+            throw std::out_of_range("FlatMap: key not found");
+
+        return index;
+    }
+};
+
+// replacement of StringKeyMap - std::string keys, std::string_view lookups (rows are proxies - see FlatMap)
+template <typename T>
+using FlatStringKeyMap = FlatMap<std::string, T>;
+
+#endif // FLAT_MAP_HPP
@@ -0,0 +1,638 @@
+#ifndef HASH_MAP_HPP
+#define HASH_MAP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define HASH_MAP_SSE2 1
+#include <emmintrin.h>
+#endif
+
+/////////////////////////////////////////////////////////////////
+// StableHash - the same 64-bit hash in every run & build
+//
+// std::hash may differ between standard libraries and versions, this one
+// depends only on bytes of a key (on little-endian hosts). Transparent -
+// std::string, std::string_view and const char* give equal hashes.
+//
+struct StableHash
+{
+    using is_transparent = void;
+
+    template <typename TWord>
+    static TWord load(const char* data) noexcept
+    {
+        TWord word;
+        std::memcpy(&word, data, sizeof(TWord));
+        return word;
+    }
+
+    static constexpr uint64_t round(uint64_t hash, uint64_t word) noexcept
+    {
+        hash = (hash ^ word) * 0xbf58476d1ce4e5b9ull;
+        return hash ^ (hash >> 29);
+    }
+
+    static constexpr uint64_t mix(uint64_t x) noexcept
+    {
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdull;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ull;
+        x ^= x >> 33;
+        return x;
+    }
+
+    uint64_t operator()(std::string_view key) const noexcept
+    {
+        const char* data = key.data();
+        const size_t size = key.size();
+        uint64_t hash = 0x9e3779b97f4a7c15ull ^ size;
+
+        // a tail is read with fixed size loads overlapping bytes already hashed - no byte loop, no memcpy call
+        uint64_t tail;
+        if (size >= 8)
+        {
+            for (size_t i = 0; i + 8 < size; i += 8)
+                hash = round(hash, load<uint64_t>(data + i));
+
+            tail = load<uint64_t>(data + size - 8);
+        }
+        else if (size >= 4)
+            tail = load<uint32_t>(data) | (uint64_t {load<uint32_t>(data + size - 4)} << 32);
+        else if (size > 0)
+            tail = (uint64_t {static_cast<unsigned char>(data[0])} << 16) | (uint64_t {static_cast<unsigned char>(data[size / 2])} << 8)
+                | static_cast<unsigned char>(data[size - 1]);
+        else
+            tail = 0;
+
+        return mix(round(hash, tail));
+    }
+
+    template <typename T, typename = std::enable_if_t<std::is_integral_v<T> || std::is_enum_v<T>>>
+    uint64_t operator()(T key) const noexcept
+    {
+        return mix(static_cast<uint64_t>(key));
+    }
+};
+
+namespace Detail
+{
+    namespace Swiss
+    {
+        // control byte of a slot: empty, deleted or 7 bits of a hash of a stored key
+        using Control = int8_t;
+
+        constexpr Control empty = -128;
+        constexpr Control deleted = -2;
+        constexpr size_t group_width = 16;
+
+        inline unsigned lowest_bit(uint32_t mask) noexcept
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return static_cast<unsigned>(__builtin_ctz(mask));
+#else
+            unsigned result = 0;
+            while ((mask & 1) == 0)
+            {
+                mask >>= 1;
+                ++result;
+            }
+            return result;
+#endif
+        }
+
+        // control bytes of 16 consecutive slots - matched all at once
+        class Group
+        {
+#ifdef HASH_MAP_SSE2
+            __m128i controls_;
+
+        public:
+            explicit Group(const Control* controls) noexcept
+                : controls_ {_mm_loadu_si128(reinterpret_cast<const __m128i*>(controls))}
+            {
+            }
+
+            uint32_t match(Control h2) const noexcept
+            {
+                return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), controls_)));
+            }
+
+            uint32_t match_empty() const noexcept
+            {
+                return match(empty);
+            }
+
+            // empty & deleted are the only negative control bytes
+            uint32_t match_free() const noexcept
+            {
+                return static_cast<uint32_t>(_mm_movemask_epi8(controls_));
+            }
+#else
+            Control controls_[group_width];
+
+        public:
+            explicit Group(const Control* controls) noexcept
+            {
+                std::memcpy(controls_, controls, group_width);
+            }
+
+            uint32_t match(Control h2) const noexcept
+            {
+                uint32_t result = 0;
+                for (size_t i = 0; i < group_width; ++i)
+                    result |= uint32_t {controls_[i] == h2} << i;
+                return result;
+            }
+
+            uint32_t match_empty() const noexcept
+            {
+                return match(empty);
+            }
+
+            uint32_t match_free() const noexcept
+            {
+                uint32_t result = 0;
+                for (size_t i = 0; i < group_width; ++i)
+                    result |= uint32_t {controls_[i] < 0} << i;
+                return result;
+            }
+#endif
+        };
+    }
+}
+
+/////////////////////////////////////////////////////////////////
+// HashMap<K, V, Hash, Equal> - open addressing hash map (Swiss table)
+//
+// Every slot has a control byte with 7 bits of a hash of its key.
+// A lookup compares a group of 16 control bytes with one SSE2
+// instruction and compares keys only for matching bytes - usually one.
+// Lookup is heterogeneous with a transparent Hash & Equal (default for
+// string keys - find by std::string_view without a temporary string).
+//
+// Inserting may move elements (rehash) - iterators & references are
+// invalidated like in std::vector.
+//
+template <typename K, typename V, typename Hash = StableHash, typename Equal = std::equal_to<>>
+class HashMap
+{
+    using Control = Detail::Swiss::Control;
+    using Group = Detail::Swiss::Group;
+    using Slot = std::pair<K, V>;
+
+    static constexpr size_t group_width = Detail::Swiss::group_width;
+
+    struct SlotStorage
+    {
+        alignas(Slot) unsigned char bytes[sizeof(Slot)];
+    };
+
+    std::vector<Control> controls_; // capacity + group_width - last bytes mirror the first group for wrap-around loads
+    std::unique_ptr<SlotStorage[]> slots_;
+    size_t capacity_ = 0;
+    size_t size_ = 0;
+    size_t growth_left_ = 0;
+    Hash hash_;
+    Equal equal_;
+
+    template <bool IsConst>
+    class Iterator
+    {
+        using Map = std::conditional_t<IsConst, const HashMap, HashMap>;
+        using Value = std::conditional_t<IsConst, const V, V>;
+
+        Map* map_;
+        size_t index_;
+
+        friend class HashMap;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::pair<K, V>;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::pair<const K&, Value&>;
+
+        struct pointer
+        {
+            reference ref;
+
+            const reference* operator->() const noexcept
+            {
+                return &ref;
+            }
+        };
+
+        Iterator(Map* map, size_t index) noexcept
+            : map_ {map}
+            , index_ {index}
+        {
+            skip_free();
+        }
+
+        template <bool C = IsConst, typename = std::enable_if_t<C>>
+        Iterator(const Iterator<false>& other) noexcept
+            : map_ {other.map_}
+            , index_ {other.index_}
+        {
+        }
+
+        reference operator*() const noexcept
+        {
+            Slot& slot = map_->slot(index_);
+            return reference {slot.first, slot.second};
+        }
+
+        pointer operator->() const noexcept
+        {
+            return pointer {**this};
+        }
+
+        Iterator& operator++() noexcept
+        {
+            ++index_;
+            skip_free();
+            return *this;
+        }
+
+        Iterator operator++(int) noexcept
+        {
+            Iterator result = *this;
+            ++*this;
+            return result;
+        }
+
+        friend bool operator==(const Iterator& a, const Iterator& b) noexcept
+        {
+            return a.index_ == b.index_;
+        }
+
+        friend bool operator!=(const Iterator& a, const Iterator& b) noexcept
+        {
+            return a.index_ != b.index_;
+        }
+
+        template <bool>
+        friend class Iterator;
+
+    private:
+        void skip_free() noexcept
+        {
+            while (index_ < map_->capacity_ && map_->controls_[index_] < 0)
+                ++index_;
+        }
+    };
+
+public:
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = std::pair<K, V>;
+    using hasher = Hash;
+    using key_equal = Equal;
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    HashMap() = default;
+
+    HashMap(std::initializer_list<value_type> items)
+        : HashMap(items.begin(), items.end())
+    {
+    }
+
+    template <typename TIterator>
+    HashMap(TIterator first, TIterator last)
+    {
+        for (; first != last; ++first)
+            try_emplace(first->first, first->second);
+    }
+
+    HashMap(const HashMap& other)
+        : hash_ {other.hash_}
+        , equal_ {other.equal_}
+    {
+        reserve(other.size());
+        for (const auto& [key, value] : other)
+            try_emplace(key, value);
+    }
+
+    HashMap(HashMap&& other) noexcept
+    {
+        swap(other);
+    }
+
+    HashMap& operator=(HashMap other) noexcept
+    {
+        swap(other);
+        return *this;
+    }
+
+    ~HashMap()
+    {
+        destroy_slots();
+    }
+
+    void swap(HashMap& other) noexcept
+    {
+        using std::swap;
+        swap(controls_, other.controls_);
+        swap(slots_, other.slots_);
+        swap(capacity_, other.capacity_);
+        swap(size_, other.size_);
+        swap(growth_left_, other.growth_left_);
+        swap(hash_, other.hash_);
+        swap(equal_, other.equal_);
+    }
+
+    size_t size() const noexcept
+    {
+        return size_;
+    }
+
+    bool empty() const noexcept
+    {
+        return size_ == 0;
+    }
+
+    size_t capacity() const noexcept
+    {
+        return capacity_;
+    }
+
+    iterator begin() noexcept
+    {
+        return iterator {this, 0};
+    }
+
+    iterator end() noexcept
+    {
+        return iterator {this, capacity_};
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return const_iterator {this, 0};
+    }
+
+    const_iterator end() const noexcept
+    {
+        return const_iterator {this, capacity_};
+    }
+
+    void reserve(size_t count)
+    {
+        if (count > max_load(capacity_))
+            rehash(capacity_for(count));
+    }
+
+    template <typename Q>
+    iterator find(const Q& key)
+    {
+        return iterator {this, find_index(key)};
+    }
+
+    template <typename Q>
+    const_iterator find(const Q& key) const
+    {
+        return const_iterator {this, find_index(key)};
+    }
+
+    template <typename Q>
+    bool contains(const Q& key) const
+    {
+        return find_index(key) != capacity_;
+    }
+
+    template <typename Q>
+    size_t count(const Q& key) const
+    {
+        return contains(key) ? 1 : 0;
+    }
+
+    template <typename Q>
+    V& at(const Q& key)
+    {
+        return slot(checked_index(key)).second;
+    }
+
+    template <typename Q>
+    const V& at(const Q& key) const
+    {
+        return slot(checked_index(key)).second;
+    }
+
+    V& operator[](const K& key)
+    {
+        return try_emplace(key).first->second;
+    }
+
+    template <typename... TArgs>
+    std::pair<iterator, bool> try_emplace(const K& key, TArgs&&... args)
+    {
+        const uint64_t hash = hash_(key);
+
+        if (const size_t index = find_index(key, hash); index != capacity_)
+            return {iterator {this, index}, false};
+
+        size_t index = free_index(hash);
+        if (growth_left_ == 0 && (capacity_ == 0 || controls_[index] == Detail::Swiss::empty))
+        {
+            rehash(capacity_for(size_ + 1));
+            index = free_index(hash);
+        }
+
+        new (&slot(index)) Slot(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<TArgs>(args)...));
+
+        if (controls_[index] == Detail::Swiss::empty)
+            --growth_left_;
+        set_control(index, h2(hash));
+        ++size_;
+
+        return {iterator {this, index}, true};
+    }
+
+    std::pair<iterator, bool> insert(const value_type& item)
+    {
+        return try_emplace(item.first, item.second);
+    }
+
+    template <typename TValue>
+    std::pair<iterator, bool> insert_or_assign(const K& key, TValue&& value)
+    {
+        auto result = try_emplace(key, std::forward<TValue>(value));
+        if (!result.second)
+            slot(result.first.index_).second = std::forward<TValue>(value);
+
+        return result;
+    }
+
+    template <typename Q>
+    size_t erase(const Q& key)
+    {
+        const size_t index = find_index(key);
+        if (index == capacity_)
+            return 0;
+
+        slot(index).~Slot();
+        set_control(index, Detail::Swiss::deleted); // a tombstone keeps probe chains of other keys intact
+        --size_;
+        return 1;
+    }
+
+    void clear() noexcept
+    {
+        destroy_slots();
+        std::fill(controls_.begin(), controls_.end(), Detail::Swiss::empty);
+        size_ = 0;
+        growth_left_ = max_load(capacity_);
+    }
+
+private:
+    static constexpr size_t max_load(size_t capacity) noexcept
+    {
+        return capacity - capacity / 8; // 7/8
+    }
+
+    static size_t capacity_for(size_t count) noexcept
+    {
+        size_t capacity = group_width;
+        while (max_load(capacity) < count)
+            capacity *= 2;
+        return capacity;
+    }
+
+    static size_t h1(uint64_t hash) noexcept
+    {
+        return static_cast<size_t>(hash >> 7);
+    }
+
+    static Control h2(uint64_t hash) noexcept
+    {
+        return static_cast<Control>(hash & 0x7f);
+    }
+
+    Slot& slot(size_t index) const noexcept
+    {
+        return *std::launder(reinterpret_cast<Slot*>(slots_[index].bytes));
+    }
+
+    void set_control(size_t index, Control control) noexcept
+    {
+        controls_[index] = control;
+        if (index < group_width)
+            controls_[capacity_ + index] = control;
+    }
+
+    template <typename Q>
+    size_t find_index(const Q& key) const
+    {
+        return find_index(key, hash_(key));
+    }
+
+    // probes groups: pos, pos + 16, pos + 16 + 32, ... (triangular - visits every group of a power of 2 table)
+    template <typename Q>
+    size_t find_index(const Q& key, uint64_t hash) const
+    {
+        if (capacity_ == 0)
+            return capacity_;
+
+        const size_t mask = capacity_ - 1;
+        size_t position = h1(hash) & mask;
+
+        for (size_t step = group_width;; step += group_width)
+        {
+            const Group group {controls_.data() + position};
+
+            for (uint32_t matches = group.match(h2(hash)); matches != 0; matches &= matches - 1)
+            {
+                const size_t index = (position + Detail::Swiss::lowest_bit(matches)) & mask;
+                if (equal_(slot(index).first, key))
+                    return index;
+            }
+
+            if (group.match_empty() != 0)
+                return capacity_;
+
+            position = (position + step) & mask;
+        }
+    }
+
+    // the first empty or deleted slot on a probe sequence of a hash
+    size_t free_index(uint64_t hash) const noexcept
+    {
+        if (capacity_ == 0)
+            return 0;
+
+        const size_t mask = capacity_ - 1;
+        size_t position = h1(hash) & mask;
+
+        for (size_t step = group_width;; step += group_width)
+        {
+            if (const uint32_t free = Group {controls_.data() + position}.match_free(); free != 0)
+                return (position + Detail::Swiss::lowest_bit(free)) & mask;
+
+            position = (position + step) & mask;
+        }
+    }
+
+    void rehash(size_t new_capacity)
+    {
+        std::vector<Control> old_controls(new_capacity + group_width, Detail::Swiss::empty);
+        std::unique_ptr<SlotStorage[]> old_slots {new SlotStorage[new_capacity]};
+        const size_t old_capacity = capacity_;
+
+        controls_.swap(old_controls);
+        slots_.swap(old_slots);
+        capacity_ = new_capacity;
+        growth_left_ = max_load(new_capacity) - size_;
+
+        for (size_t i = 0; i < old_capacity; ++i)
+        {
+            if (old_controls[i] < 0)
+                continue;
+
+            Slot& old_slot = *std::launder(reinterpret_cast<Slot*>(old_slots[i].bytes));
+            const uint64_t hash = hash_(old_slot.first);
+            const size_t index = free_index(hash);
+
+            new (&slot(index)) Slot(std::move(old_slot));
+            old_slot.~Slot();
+            set_control(index, h2(hash));
+        }
+    }
+
+    template <typename Q>
+    size_t checked_index(const Q& key) const
+    {
+        const size_t index = find_index(key);
+        if (index == capacity_)
+            throw std::out_of_range("HashMap: key not found");
+
+        return index;
+    }
+
+    void destroy_slots() noexcept
+    {
+        if constexpr (!std::is_trivially_destructible_v<Slot>)
+            for (size_t i = 0; i < capacity_; ++i)
+                if (controls_[i] >= 0)
+                    slot(i).~Slot();
+    }
+};
+
+// StringKeyMap with a hash table - std::string keys, std::string_view lookups
+template <typename T>
+using HashStringKeyMap = HashMap<std::string, T>;
+
+#endif // HASH_MAP_HPP
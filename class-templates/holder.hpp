@@ -0,0 +1,121 @@
+#ifndef HOLDER_HPP
+#define HOLDER_HPP
+
+#include "ref_counted.hpp"
+#include <iostream>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+
+template <typename T>
+class Holder
+{
+    T item_;
+
+public:
+    //typedef T value_type;
+    using value_type = T;
+
+    Holder(T& item)
+        : item_ {item}
+    {
+    }
+
+    Holder(T&& item)
+        : item_ {std::move(item)}
+    {
+    }
+
+    T& value()
+    {
+        return item_;
+    }
+
+    const T& value() const;
+
+    void info() const
+    {
+        std::cout << "Holder<T: " << typeid(T).name() << ">(" << item_ << ")\n";
+    }
+};
+
+// deduction guide - C++17 (CTAD)
+template <typename T>
+Holder(T) -> Holder<T>;
+
+template <typename T>
+const T& Holder<T>::value() const
+{
+    return item_;
+}
+
+// unique ownership of T - shared ownership if T keeps its own reference counter (RefCounted)
+template <typename T>
+class Holder<T*>
+{
+    using Owner = std::conditional_t<is_intrusive_v<T>, IntrusivePtr<T>, std::unique_ptr<T>>;
+
+    Owner item_;
+public:
+    using value_type = T;
+
+    Holder(T* item)
+        : item_ {item}
+    {
+    }
+
+    T& value()
+    {
+        return *item_;
+    }
+
+    const T& value() const
+    {
+        return *item_;
+    }
+
+    T* get() const
+    {
+        return item_.get();
+    }
+
+    void info() const
+    {
+        std::cout << "Holder<T*: " << typeid(T).name() << ">(" << item_.get()
+        << " - " << *item_ << ")\n";
+    }
+};
+
+// length is computed once - value() does not scan for a terminator
+template <>
+class Holder<const char*>
+{
+    std::string_view item_;
+public:
+    using value_type = const char*;
+
+    Holder(const char* item)
+        : item_ {item}
+    {
+    }
+
+    std::string_view value() const
+    {
+        return item_;
+    }
+
+    void info() const
+    {
+        std::cout << "Holder<const char*>(" << item_ << ")\n";
+    }
+};
+
+template <typename T>
+Holder<T> make_holder(T item)
+{
+    return Holder<T>(item);
+}
+
+#endif // HOLDER_HPP
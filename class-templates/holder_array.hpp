@@ -0,0 +1,356 @@
+#ifndef HOLDER_ARRAY_HPP
+#define HOLDER_ARRAY_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+/////////////////////////////////////////////////////////////////
+// PackingTraits<T> - number of bits needed to store a value of T
+//
+// bool needs one bit. Enums use their full underlying type unless
+// narrowed with EnumPacking:
+//
+//   template <>
+//   struct PackingTraits<Color> : EnumPacking<Color, Color::blue>
+//   {
+//   };
+//
+template <typename T, typename = void>
+struct PackingTraits
+{
+    static constexpr unsigned bits = sizeof(T) * CHAR_BIT;
+};
+
+template <>
+struct PackingTraits<bool>
+{
+    static constexpr unsigned bits = 1;
+};
+
+// values of E are in [0, MaxValue]
+template <typename E, E MaxValue>
+struct EnumPacking
+{
+    static_assert(std::is_enum_v<E>, "enums only");
+    static_assert(static_cast<std::underlying_type_t<E>>(MaxValue) >= 0, "negative values can not be packed");
+
+    static constexpr unsigned bits = [] {
+        unsigned result = 1;
+        for (auto value = static_cast<uint64_t>(MaxValue); value > 1; value >>= 1)
+            ++result;
+        return result;
+    }();
+};
+
+namespace Detail
+{
+    template <typename T, typename = void>
+    struct RawType
+    {
+        using type = std::make_unsigned_t<T>;
+    };
+
+    template <typename T>
+    struct RawType<T, std::enable_if_t<std::is_enum_v<T>>>
+    {
+        using type = std::make_unsigned_t<std::underlying_type_t<T>>;
+    };
+
+    template <>
+    struct RawType<bool>
+    {
+        using type = uint8_t;
+    };
+
+    constexpr unsigned round_up_to_power_of_2(unsigned bits) noexcept
+    {
+        unsigned result = 1;
+        while (result < bits)
+            result *= 2;
+        return result;
+    }
+}
+
+/////////////////////////////////////////////////////////////////
+// HolderArray<T> - compact replacement for std::vector<Holder<T>>
+//
+// Values of small trivially copyable types are packed into 64-bit words
+// (a power of 2 bits per value, so no value spans two words). Access to
+// an element goes through a proxy reference - like std::vector<bool> -
+// bulk operations (fill, count, flip) process a whole word at a time.
+//
+template <typename T>
+class HolderArray
+{
+    static_assert(std::is_integral_v<T> || std::is_enum_v<T>, "integral types, bool & enums only");
+
+    using Word = uint64_t;
+    using Raw = typename Detail::RawType<T>::type;
+
+    static constexpr unsigned word_bits = 64;
+    static constexpr unsigned bits = Detail::round_up_to_power_of_2(PackingTraits<T>::bits);
+    static constexpr unsigned per_word = word_bits / bits;
+    static constexpr Word value_mask = bits == word_bits ? ~Word {0} : (Word {1} << bits) - 1;
+
+    static_assert(bits <= word_bits);
+
+    // lowest / highest bit of every value in a word
+    static constexpr Word low_bits = ~Word {0} / value_mask;
+    static constexpr Word high_bits = low_bits << (bits - 1);
+
+    std::vector<Word> words_;
+    size_t size_ = 0;
+
+public:
+    using value_type = T;
+    static constexpr unsigned bits_per_value = bits;
+
+    class Reference
+    {
+        HolderArray& array_;
+        size_t index_;
+
+    public:
+        Reference(HolderArray& array, size_t index) noexcept
+            : array_ {array}
+            , index_ {index}
+        {
+        }
+
+        operator T() const noexcept
+        {
+            return array_.get(index_);
+        }
+
+        Reference& operator=(T value) noexcept
+        {
+            array_.set(index_, value);
+            return *this;
+        }
+
+        Reference& operator=(const Reference& other) noexcept
+        {
+            return *this = static_cast<T>(other);
+        }
+    };
+
+    class ConstIterator
+    {
+        const HolderArray* array_;
+        size_t index_;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = T;
+
+        ConstIterator(const HolderArray* array, size_t index) noexcept
+            : array_ {array}
+            , index_ {index}
+        {
+        }
+
+        T operator*() const noexcept
+        {
+            return array_->get(index_);
+        }
+
+        ConstIterator& operator++() noexcept
+        {
+            ++index_;
+            return *this;
+        }
+
+        ConstIterator operator++(int) noexcept
+        {
+            ConstIterator result = *this;
+            ++index_;
+            return result;
+        }
+
+        bool operator==(const ConstIterator& other) const noexcept
+        {
+            return index_ == other.index_;
+        }
+
+        bool operator!=(const ConstIterator& other) const noexcept
+        {
+            return index_ != other.index_;
+        }
+    };
+
+    HolderArray() = default;
+
+    explicit HolderArray(size_t size, T value = T {})
+    {
+        resize(size, value);
+    }
+
+    size_t size() const noexcept
+    {
+        return size_;
+    }
+
+    bool empty() const noexcept
+    {
+        return size_ == 0;
+    }
+
+    // bytes allocated for values
+    size_t memory_usage() const noexcept
+    {
+        return words_.capacity() * sizeof(Word);
+    }
+
+    T get(size_t index) const noexcept
+    {
+        assert(index < size_);
+
+        const Word raw = (words_[index / per_word] >> shift(index)) & value_mask;
+        return static_cast<T>(static_cast<Raw>(raw));
+    }
+
+    void set(size_t index, T value) noexcept
+    {
+        assert(index < size_);
+
+        Word& word = words_[index / per_word];
+        word = (word & ~(value_mask << shift(index))) | (to_raw(value) << shift(index));
+    }
+
+    Reference operator[](size_t index) noexcept
+    {
+        return Reference {*this, index};
+    }
+
+    T operator[](size_t index) const noexcept
+    {
+        return get(index);
+    }
+
+    ConstIterator begin() const noexcept
+    {
+        return ConstIterator {this, 0};
+    }
+
+    ConstIterator end() const noexcept
+    {
+        return ConstIterator {this, size_};
+    }
+
+    void push_back(T value)
+    {
+        if (size_ % per_word == 0)
+            words_.push_back(0);
+
+        ++size_;
+        set(size_ - 1, value);
+    }
+
+    void resize(size_t size, T value = T {})
+    {
+        const size_t old_size = size_;
+
+        words_.resize((size + per_word - 1) / per_word, 0);
+        size_ = size;
+        clear_unused_bits();
+
+        for (size_t i = old_size; i < size && i % per_word != 0; ++i)
+            set(i, value);
+
+        const size_t first_new_word = (old_size + per_word - 1) / per_word;
+        std::fill(words_.begin() + std::min(first_new_word, words_.size()), words_.end(), broadcast(value));
+        clear_unused_bits();
+    }
+
+    void fill(T value) noexcept
+    {
+        std::fill(words_.begin(), words_.end(), broadcast(value));
+        clear_unused_bits();
+    }
+
+    size_t count(T value) const noexcept
+    {
+        if (size_ == 0)
+            return 0;
+
+        const Word pattern = broadcast(value);
+        size_t mismatches = 0;
+
+        for (size_t i = 0; i + 1 < words_.size(); ++i)
+            mismatches += popcount(nonzero_values(words_[i] ^ pattern));
+
+        mismatches += popcount(nonzero_values(words_.back() ^ pattern) & used_high_bits());
+
+        return size_ - mismatches;
+    }
+
+    template <typename U = T, typename = std::enable_if_t<std::is_same_v<U, bool>>>
+    void flip() noexcept
+    {
+        for (Word& word : words_)
+            word = ~word;
+        clear_unused_bits();
+    }
+
+private:
+    static Word to_raw(T value) noexcept
+    {
+        const Word raw = static_cast<Raw>(value);
+        assert((raw & ~value_mask) == 0 && "value does not fit in PackingTraits<T>::bits");
+        return raw;
+    }
+
+    static unsigned shift(size_t index) noexcept
+    {
+        return static_cast<unsigned>(index % per_word) * bits;
+    }
+
+    static Word broadcast(T value) noexcept
+    {
+        return to_raw(value) * low_bits;
+    }
+
+    // sets the highest bit of every non-zero value in a word (SWAR - no carries between values)
+    static Word nonzero_values(Word word) noexcept
+    {
+        const Word low_part = ~high_bits;
+        return (((word & low_part) + low_part) | word) & high_bits;
+    }
+
+    static size_t popcount(Word word) noexcept
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<size_t>(__builtin_popcountll(word));
+#else
+        size_t result = 0;
+        for (; word != 0; word &= word - 1)
+            ++result;
+        return result;
+#endif
+    }
+
+    Word used_high_bits() const noexcept
+    {
+        const size_t used = size_ - (words_.size() - 1) * per_word;
+        return used == per_word ? high_bits : high_bits & ((Word {1} << (used * bits)) - 1);
+    }
+
+    // bits after the last value are always zero
+    void clear_unused_bits() noexcept
+    {
+        const size_t used = size_ % per_word;
+        if (used != 0)
+            words_.back() &= (Word {1} << (used * bits)) - 1;
+    }
+};
+
+#endif // HOLDER_ARRAY_HPP
@@ -0,0 +1,257 @@
+#ifndef LOCK_FREE_STACK_HPP
+#define LOCK_FREE_STACK_HPP
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+/////////////////////////////////////////////////////////////////
+// LockFreeStack<T, A> - Treiber stack for many producers & consumers
+//
+// ABA protection: nodes are addressed by a 32-bit index, and the head
+// keeps a 32-bit tag next to it in a single 64-bit atomic. Every
+// successful CAS bumps the tag, so a head that was popped & pushed back
+// in the meantime does not compare equal.
+//
+// Reclamation: popped nodes go to a lock-free free list and are reused,
+// segments of nodes are released only in the destructor. A node read by
+// a thread that lost a race is therefore always valid memory (its stale
+// 'next' is rejected by the tag) - no hazard pointers or epochs needed.
+// Memory is bounded by the maximum number of items held at once.
+//
+// Fits template-template parameters Container<T, A> (e.g. of Stack).
+//
+template <typename T, typename A = std::allocator<T>>
+class LockFreeStack
+{
+    struct Node
+    {
+        std::atomic<uint32_t> next {null_index};
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        T& value() noexcept
+        {
+            return *std::launder(reinterpret_cast<T*>(storage));
+        }
+    };
+
+    using NodeAllocator = typename std::allocator_traits<A>::template rebind_alloc<Node>;
+    using NodeAllocatorTraits = std::allocator_traits<NodeAllocator>;
+
+    static constexpr uint32_t null_index = UINT32_MAX;
+    static constexpr size_t first_segment_size = 64;
+    static constexpr size_t segment_count = 26; // 64 * (2^26 - 1) nodes fit in 32-bit indexes
+
+    // index in low, tag in high half
+    using TaggedIndex = uint64_t;
+
+    static constexpr uint32_t index_of(TaggedIndex tagged) noexcept
+    {
+        return static_cast<uint32_t>(tagged);
+    }
+
+    static constexpr TaggedIndex retag(TaggedIndex old, uint32_t index) noexcept
+    {
+        return ((old >> 32) + 1) << 32 | index;
+    }
+
+    alignas(64) std::atomic<TaggedIndex> head_ {null_index};
+    alignas(64) std::atomic<TaggedIndex> free_ {null_index};
+    alignas(64) std::atomic<uint32_t> allocated_ {0};
+    std::atomic<Node*> segments_[segment_count] = {};
+    NodeAllocator allocator_;
+
+public:
+    using value_type = T;
+    using allocator_type = A;
+
+    LockFreeStack() = default;
+
+    explicit LockFreeStack(const A& allocator)
+        : allocator_ {allocator}
+    {
+    }
+
+    LockFreeStack(const LockFreeStack&) = delete;
+    LockFreeStack& operator=(const LockFreeStack&) = delete;
+
+    ~LockFreeStack()
+    {
+        for (uint32_t index = index_of(head_.load()); index != null_index;)
+        {
+            Node& current = node(index);
+            current.value().~T();
+            index = current.next.load(std::memory_order_relaxed);
+        }
+
+        for (size_t k = 0; k < segment_count; ++k)
+            if (Node* segment = segments_[k].load())
+                release_segment(segment, segment_size(k));
+    }
+
+    void push(const T& item)
+    {
+        emplace(item);
+    }
+
+    void push(T&& item)
+    {
+        emplace(std::move(item));
+    }
+
+    void push_back(const T& item)
+    {
+        emplace(item);
+    }
+
+    void push_back(T&& item)
+    {
+        emplace(std::move(item));
+    }
+
+    template <typename... TArgs>
+    void emplace(TArgs&&... args)
+    {
+        const uint32_t index = acquire_node();
+        Node& new_node = node(index);
+
+        try
+        {
+            new (new_node.storage) T(std::forward<TArgs>(args)...);
+        }
+        catch (...)
+        {
+            link(free_, index);
+            throw;
+        }
+
+        link(head_, index);
+    }
+
+    bool try_pop(T& item)
+    {
+        const uint32_t index = unlink(head_);
+        if (index == null_index)
+            return false;
+
+        Node& popped = node(index);
+        item = std::move(popped.value());
+        popped.value().~T();
+
+        link(free_, index);
+        return true;
+    }
+
+    // a snapshot - may be outdated as soon as it is returned
+    bool empty() const noexcept
+    {
+        return index_of(head_.load(std::memory_order_acquire)) == null_index;
+    }
+
+    // nodes allocated so far - the high-water mark of stack size
+    size_t capacity() const noexcept
+    {
+        return allocated_.load(std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr size_t segment_size(size_t k) noexcept
+    {
+        return first_segment_size << k;
+    }
+
+    // segment k holds indexes [64 * (2^k - 1), 64 * (2^(k+1) - 1))
+    static size_t segment_of(uint32_t index) noexcept
+    {
+        const uint64_t position = index / first_segment_size + 1;
+#if defined(__GNUC__) || defined(__clang__)
+        return 63 - static_cast<size_t>(__builtin_clzll(position));
+#else
+        size_t k = 0;
+        while ((position >> (k + 1)) != 0)
+            ++k;
+        return k;
+#endif
+    }
+
+    Node& node(uint32_t index) const noexcept
+    {
+        const size_t k = segment_of(index);
+        Node* segment = segments_[k].load(std::memory_order_acquire);
+        assert(segment != nullptr);
+
+        return segment[index - first_segment_size * ((size_t {1} << k) - 1)];
+    }
+
+    void link(std::atomic<TaggedIndex>& list, uint32_t index) noexcept
+    {
+        Node& new_node = node(index);
+        TaggedIndex old = list.load(std::memory_order_relaxed);
+
+        do
+        {
+            new_node.next.store(index_of(old), std::memory_order_relaxed);
+        } while (!list.compare_exchange_weak(old, retag(old, index), std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    uint32_t unlink(std::atomic<TaggedIndex>& list) noexcept
+    {
+        TaggedIndex old = list.load(std::memory_order_acquire);
+
+        while (index_of(old) != null_index)
+        {
+            // the node may be popped & reused meanwhile - then its next is stale, but the tag makes the CAS fail
+            const uint32_t next = node(index_of(old)).next.load(std::memory_order_relaxed);
+
+            if (list.compare_exchange_weak(old, retag(old, next), std::memory_order_acquire, std::memory_order_acquire))
+                return index_of(old);
+        }
+
+        return null_index;
+    }
+
+    uint32_t acquire_node()
+    {
+        if (const uint32_t index = unlink(free_); index != null_index)
+            return index;
+
+        const uint32_t index = allocated_.fetch_add(1, std::memory_order_relaxed);
+        if (index >= first_segment_size * ((size_t {1} << segment_count) - 1))
+            throw std::length_error("LockFreeStack: too many nodes");
+
+        const size_t k = segment_of(index);
+        if (segments_[k].load(std::memory_order_acquire) == nullptr)
+        {
+            Node* segment = allocate_segment(segment_size(k));
+            Node* expected = nullptr;
+            if (!segments_[k].compare_exchange_strong(expected, segment, std::memory_order_acq_rel))
+                release_segment(segment, segment_size(k)); // another thread was first
+        }
+
+        return index;
+    }
+
+    Node* allocate_segment(size_t size)
+    {
+        Node* segment = NodeAllocatorTraits::allocate(allocator_, size);
+        for (size_t i = 0; i < size; ++i)
+            new (segment + i) Node {};
+
+        return segment;
+    }
+
+    void release_segment(Node* segment, size_t size) noexcept
+    {
+        for (size_t i = 0; i < size; ++i)
+            segment[i].~Node();
+
+        NodeAllocatorTraits::deallocate(allocator_, segment, size);
+    }
+};
+
+#endif // LOCK_FREE_STACK_HPP
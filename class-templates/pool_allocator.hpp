@@ -0,0 +1,190 @@
+#ifndef POOL_ALLOCATOR_HPP
+#define POOL_ALLOCATOR_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+/////////////////////////////////////////////////////////////////
+// Arena - chunked memory with free lists per block size
+//
+// Blocks up to max_block bytes are carved from 64 KiB chunks and
+// recycled through a free list of their size class, bigger requests go
+// to operator new. An arena is not synchronized - it allocates & frees
+// without locks, so all containers using one arena must be used by one
+// thread at a time. Containers must not outlive the arena.
+//
+class Arena
+{
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    static constexpr size_t chunk_size = 64 * 1024;
+    static constexpr size_t granularity = alignof(std::max_align_t);
+    static constexpr size_t size_classes = 16;
+
+    std::vector<void*> chunks_;
+    std::byte* current_ = nullptr;
+    size_t remaining_ = 0;
+    FreeBlock* free_lists_[size_classes] = {};
+
+public:
+    static constexpr size_t max_block = granularity * size_classes;
+
+    Arena() = default;
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    ~Arena()
+    {
+        release();
+    }
+
+    void* allocate(size_t bytes)
+    {
+        if (bytes > max_block)
+            return ::operator new(bytes);
+
+        const size_t size_class = class_of(bytes);
+        if (FreeBlock* block = free_lists_[size_class])
+        {
+            free_lists_[size_class] = block->next;
+            return block;
+        }
+
+        const size_t block_size = (size_class + 1) * granularity;
+        if (remaining_ < block_size)
+            add_chunk();
+
+        void* block = current_;
+        current_ += block_size;
+        remaining_ -= block_size;
+        return block;
+    }
+
+    void deallocate(void* ptr, size_t bytes) noexcept
+    {
+        if (bytes > max_block)
+        {
+            ::operator delete(ptr);
+            return;
+        }
+
+        const size_t size_class = class_of(bytes);
+        free_lists_[size_class] = new (ptr) FreeBlock {free_lists_[size_class]};
+    }
+
+    // bulk release of all blocks at once - no block of this arena may be used afterwards
+    void release() noexcept
+    {
+        for (void* chunk : chunks_)
+            ::operator delete(chunk);
+
+        chunks_.clear();
+        current_ = nullptr;
+        remaining_ = 0;
+        std::fill(std::begin(free_lists_), std::end(free_lists_), nullptr);
+    }
+
+    size_t bytes_reserved() const noexcept
+    {
+        return chunks_.size() * chunk_size;
+    }
+
+private:
+    static size_t class_of(size_t bytes) noexcept
+    {
+        return bytes == 0 ? 0 : (bytes - 1) / granularity;
+    }
+
+    void add_chunk()
+    {
+        chunks_.reserve(chunks_.size() + 1);
+        current_ = static_cast<std::byte*>(::operator new(chunk_size));
+        chunks_.push_back(current_);
+        remaining_ = chunk_size; // a rest of a previous chunk is abandoned - at most max_block bytes
+    }
+};
+
+/////////////////////////////////////////////////////////////////
+// PoolAllocator<T> - allocator of single nodes from an Arena
+//
+// Meant for node based containers (std::list, std::map, Stack<T, std::list>):
+// every node is one allocate(1) call. Arrays (n > 1) bypass the arena.
+// There is no default constructor - a lifetime of an arena is chosen
+// explicitly, a container must not outlive it:
+//
+//   Arena arena;
+//   std::list<int, PoolAllocator<int>> items {PoolAllocator<int> {arena}};
+//
+// An allocator propagates with its container on assignment and swap, so
+// nodes are always freed to the arena they came from.
+//
+template <typename T>
+class PoolAllocator
+{
+    static_assert(alignof(T) <= alignof(std::max_align_t), "over-aligned types are not supported");
+
+    Arena* arena_;
+
+    template <typename U>
+    friend class PoolAllocator;
+
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    using is_always_equal = std::false_type;
+
+    explicit PoolAllocator(Arena& arena) noexcept
+        : arena_ {&arena}
+    {
+    }
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>& other) noexcept
+        : arena_ {other.arena_}
+    {
+    }
+
+    T* allocate(size_t n)
+    {
+        if (n == 1)
+            return static_cast<T*>(arena_->allocate(sizeof(T)));
+
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T* ptr, size_t n) noexcept
+    {
+        if (n == 1)
+            arena_->deallocate(ptr, sizeof(T));
+        else
+            ::operator delete(ptr);
+    }
+
+    Arena& arena() const noexcept
+    {
+        return *arena_;
+    }
+
+    template <typename U>
+    friend bool operator==(const PoolAllocator& a, const PoolAllocator<U>& b) noexcept
+    {
+        return &a.arena() == &b.arena();
+    }
+
+    template <typename U>
+    friend bool operator!=(const PoolAllocator& a, const PoolAllocator<U>& b) noexcept
+    {
+        return !(a == b);
+    }
+};
+
+#endif // POOL_ALLOCATOR_HPP
@@ -0,0 +1,185 @@
+#ifndef REF_COUNTED_HPP
+#define REF_COUNTED_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+/////////////////////////////////////////////////////////////////
+// CountPolicy - how a reference counter is stored & updated
+//
+struct AtomicCount
+{
+    using Counter = std::atomic<uint32_t>;
+
+    static void increment(Counter& counter) noexcept
+    {
+        counter.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // true if the last reference was released - acquire makes all writes of other owners visible to a destructor
+    static bool decrement(Counter& counter) noexcept
+    {
+        return counter.fetch_sub(1, std::memory_order_acq_rel) == 1;
+    }
+
+    static uint32_t load(const Counter& counter) noexcept
+    {
+        return counter.load(std::memory_order_relaxed);
+    }
+};
+
+/////////////////////////////////////////////////////////////////
+// CountPolicy - for objects shared by one thread only
+//
+struct LocalCount
+{
+    using Counter = uint32_t;
+
+    static void increment(Counter& counter) noexcept
+    {
+        ++counter;
+    }
+
+    static bool decrement(Counter& counter) noexcept
+    {
+        return --counter == 0;
+    }
+
+    static uint32_t load(const Counter& counter) noexcept
+    {
+        return counter;
+    }
+};
+
+/////////////////////////////////////////////////////////////////
+// RefCounted<CountPolicy> - base class keeping a reference counter inside an object
+//
+// A copy of an object starts with its own counter - counters are never copied.
+// Objects deleted through a pointer to a base class need a virtual destructor.
+//
+template <typename TCountPolicy = AtomicCount>
+class RefCounted
+{
+    mutable typename TCountPolicy::Counter ref_count_ {0};
+
+public:
+    RefCounted() = default;
+
+    RefCounted(const RefCounted&) noexcept
+    {
+    }
+
+    RefCounted& operator=(const RefCounted&) noexcept
+    {
+        return *this;
+    }
+
+    void add_ref() const noexcept
+    {
+        TCountPolicy::increment(ref_count_);
+    }
+
+    // true when the last reference is gone
+    bool release_ref() const noexcept
+    {
+        return TCountPolicy::decrement(ref_count_);
+    }
+
+    uint32_t ref_count() const noexcept
+    {
+        return TCountPolicy::load(ref_count_);
+    }
+
+protected:
+    ~RefCounted() = default;
+};
+
+template <typename T, typename = void>
+struct IsIntrusive : std::false_type
+{
+};
+
+template <typename T>
+struct IsIntrusive<T, std::void_t<decltype(std::declval<const T&>().add_ref()), decltype(std::declval<const T&>().release_ref())>>
+    : std::true_type
+{
+};
+
+template <typename T>
+constexpr bool is_intrusive_v = IsIntrusive<T>::value;
+
+/////////////////////////////////////////////////////////////////
+// IntrusivePtr<T> - shared ownership of T with a counter inside T
+//
+// Unlike std::shared_ptr there is no control block: a copy is one
+// increment of a counter in the pointee, and a pointer is a single word.
+//
+template <typename T>
+class IntrusivePtr
+{
+    static_assert(is_intrusive_v<T>, "T has to provide add_ref() & release_ref() - e.g. derive from RefCounted");
+
+    T* ptr_ = nullptr;
+
+public:
+    IntrusivePtr() noexcept = default;
+
+    // takes a reference - a fresh object (counter 0) becomes owned by this pointer
+    explicit IntrusivePtr(T* ptr) noexcept
+        : ptr_ {ptr}
+    {
+        if (ptr_)
+            ptr_->add_ref();
+    }
+
+    IntrusivePtr(const IntrusivePtr& other) noexcept
+        : IntrusivePtr(other.ptr_)
+    {
+    }
+
+    IntrusivePtr(IntrusivePtr&& other) noexcept
+        : ptr_ {std::exchange(other.ptr_, nullptr)}
+    {
+    }
+
+    IntrusivePtr& operator=(IntrusivePtr other) noexcept
+    {
+        std::swap(ptr_, other.ptr_);
+        return *this;
+    }
+
+    ~IntrusivePtr()
+    {
+        if (ptr_ && ptr_->release_ref())
+            delete ptr_;
+    }
+
+    T* get() const noexcept
+    {
+        return ptr_;
+    }
+
+    T& operator*() const noexcept
+    {
+        return *ptr_;
+    }
+
+    T* operator->() const noexcept
+    {
+        return ptr_;
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return ptr_ != nullptr;
+    }
+
+    uint32_t use_count() const noexcept
+    {
+        return ptr_ ? ptr_->ref_count() : 0;
+    }
+};
+
+#endif // REF_COUNTED_HPP
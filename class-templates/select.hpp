@@ -0,0 +1,37 @@
+#ifndef SELECT_HPP
+#define SELECT_HPP
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/////////////////////////////////////////////////////////////////
+// select<I...>(tuple) - projection of chosen elements of a tuple
+//
+//   tuple<int, double, string> tpl(1, 3.14, "text");
+//   tuple<int, string> projection = select<0, 2>(tpl);
+//
+// Works for anything with std::tuple_element & std::get (std::pair,
+// std::array). Elements are copied - or moved out of an rvalue tuple;
+// select_ref<I...> makes a tuple of references instead.
+//
+template <size_t... Is, typename TTuple>
+constexpr auto select(const TTuple& tpl)
+{
+    return std::tuple<std::tuple_element_t<Is, TTuple>...>(std::get<Is>(tpl)...);
+}
+
+template <size_t... Is, typename TTuple, typename = std::enable_if_t<!std::is_lvalue_reference_v<TTuple>>>
+constexpr auto select(TTuple&& tpl)
+{
+    return std::tuple<std::tuple_element_t<Is, TTuple>...>(std::get<Is>(std::move(tpl))...);
+}
+
+template <size_t... Is, typename TTuple>
+constexpr auto select_ref(TTuple& tpl) noexcept
+{
+    return std::tuple<std::tuple_element_t<Is, TTuple>&...>(std::get<Is>(tpl)...);
+}
+
+#endif // SELECT_HPP
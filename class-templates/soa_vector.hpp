@@ -0,0 +1,297 @@
+#ifndef SOA_VECTOR_HPP
+#define SOA_VECTOR_HPP
+
+#include "select.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Detail
+{
+    // bool stored in a byte - elements of std::vector<Flag> are addressable
+    struct Flag
+    {
+        bool value;
+
+        Flag(bool value = false) noexcept
+            : value {value}
+        {
+        }
+    };
+
+    template <typename T>
+    struct ColumnStorage
+    {
+        using type = T;
+    };
+
+    template <>
+    struct ColumnStorage<bool>
+    {
+        using type = Flag;
+    };
+
+    template <typename T>
+    T& column_element(T& item) noexcept
+    {
+        return item;
+    }
+
+    inline bool& column_element(Flag& flag) noexcept
+    {
+        return flag.value;
+    }
+
+    inline const bool& column_element(const Flag& flag) noexcept
+    {
+        return flag.value;
+    }
+}
+
+/////////////////////////////////////////////////////////////////
+// SoaVector<Ts...> - vector of records stored as a struct of arrays
+//
+// Every field (column) of a record lives in its own std::vector, so a loop
+// over two of ten fields streams only those two columns through a cache:
+//
+//   SoaVector<int, double, string> records;
+//   for (auto [id, price] : select<0, 1>(records))
+//       ...
+//
+// select<I...> is a view - no column is copied. Rows are accessed as
+// tuples of references (operator[]) or copied out as tuples (row()).
+//
+// A bool column stores one byte per flag (Detail::Flag) - std::vector<bool>
+// has neither data() nor bool& elements.
+//
+template <typename... Ts>
+class SoaVector
+{
+    static_assert(sizeof...(Ts) > 0, "at least one column");
+
+    std::tuple<std::vector<typename Detail::ColumnStorage<Ts>::type>...> columns_;
+
+public:
+    template <size_t I>
+    using Column = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+    // element type of a column vector - Column<I> except Detail::Flag for bool
+    template <size_t I>
+    using Stored = typename Detail::ColumnStorage<Column<I>>::type;
+
+    // rows restricted to columns Is... - pointers into columns, valid until a size of a vector changes
+    template <bool IsConst, size_t... Is>
+    class Projection
+    {
+        static_assert(sizeof...(Is) > 0, "at least one column");
+
+        template <size_t I>
+        using Pointer = std::conditional_t<IsConst, const Stored<I>*, Stored<I>*>;
+
+        template <size_t I>
+        using Reference = std::conditional_t<IsConst, const Column<I>&, Column<I>&>;
+
+        std::tuple<Pointer<Is>...> data_;
+        size_t size_;
+
+    public:
+        using value_type = std::tuple<Column<Is>...>;
+        using reference = std::tuple<Reference<Is>...>;
+
+        class Iterator
+        {
+            std::tuple<Pointer<Is>...> positions_;
+
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = Projection::value_type;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = Projection::reference;
+
+            explicit Iterator(std::tuple<Pointer<Is>...> positions) noexcept
+                : positions_ {positions}
+            {
+            }
+
+            reference operator*() const noexcept
+            {
+                return std::apply([](auto*... position) { return reference {Detail::column_element(*position)...}; }, positions_);
+            }
+
+            Iterator& operator++() noexcept
+            {
+                std::apply([](auto*&... position) { (++position, ...); }, positions_);
+                return *this;
+            }
+
+            Iterator operator++(int) noexcept
+            {
+                Iterator result = *this;
+                ++*this;
+                return result;
+            }
+
+            // all columns advance together - the first one is enough
+            bool operator==(const Iterator& other) const noexcept
+            {
+                return std::get<0>(positions_) == std::get<0>(other.positions_);
+            }
+
+            bool operator!=(const Iterator& other) const noexcept
+            {
+                return !(*this == other);
+            }
+        };
+
+        Projection(std::tuple<Pointer<Is>...> data, size_t size) noexcept
+            : data_ {data}
+            , size_ {size}
+        {
+        }
+
+        size_t size() const noexcept
+        {
+            return size_;
+        }
+
+        reference operator[](size_t index) const noexcept
+        {
+            assert(index < size_);
+            return std::apply([index](auto*... column) { return reference {Detail::column_element(column[index])...}; }, data_);
+        }
+
+        Iterator begin() const noexcept
+        {
+            return Iterator {data_};
+        }
+
+        Iterator end() const noexcept
+        {
+            return Iterator {std::apply([this](auto*... column) { return std::tuple<Pointer<Is>...> {column + size_...}; }, data_)};
+        }
+    };
+
+    SoaVector() = default;
+
+    size_t size() const noexcept
+    {
+        return std::get<0>(columns_).size();
+    }
+
+    bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    void reserve(size_t capacity)
+    {
+        std::apply([capacity](auto&... column) { (column.reserve(capacity), ...); }, columns_);
+    }
+
+    void clear() noexcept
+    {
+        std::apply([](auto&... column) { (column.clear(), ...); }, columns_);
+    }
+
+    template <typename... TArgs>
+    void emplace_back(TArgs&&... args)
+    {
+        static_assert(sizeof...(TArgs) == sizeof...(Ts), "one value for every column");
+
+        emplace_back_impl(std::index_sequence_for<Ts...> {}, std::forward<TArgs>(args)...);
+    }
+
+    void push_back(const std::tuple<Ts...>& row)
+    {
+        std::apply([this](const auto&... value) { emplace_back(value...); }, row);
+    }
+
+    template <size_t I>
+    std::vector<Stored<I>>& column() noexcept
+    {
+        return std::get<I>(columns_);
+    }
+
+    template <size_t I>
+    const std::vector<Stored<I>>& column() const noexcept
+    {
+        return std::get<I>(columns_);
+    }
+
+    std::tuple<Ts&...> operator[](size_t index) noexcept
+    {
+        assert(index < size());
+        return std::apply([index](auto&... column) { return std::tuple<Ts&...> {Detail::column_element(column[index])...}; }, columns_);
+    }
+
+    std::tuple<const Ts&...> operator[](size_t index) const noexcept
+    {
+        assert(index < size());
+        return std::apply([index](const auto&... column) { return std::tuple<const Ts&...> {Detail::column_element(column[index])...}; }, columns_);
+    }
+
+    // copy of a record - e.g. to move it into an array of structs
+    std::tuple<Ts...> row(size_t index) const
+    {
+        return std::tuple<Ts...>((*this)[index]);
+    }
+
+    template <size_t... Is>
+    Projection<false, Is...> select() noexcept
+    {
+        return Projection<false, Is...> {std::tuple<Stored<Is>*...> {std::get<Is>(columns_).data()...}, size()};
+    }
+
+    template <size_t... Is>
+    Projection<true, Is...> select() const noexcept
+    {
+        return Projection<true, Is...> {std::tuple<const Stored<Is>*...> {std::get<Is>(columns_).data()...}, size()};
+    }
+
+private:
+    // all columns grow or none does - capacity is reserved up front, a row appended partially is popped back
+    template <size_t... Is, typename... TArgs>
+    void emplace_back_impl(std::index_sequence<Is...>, TArgs&&... args)
+    {
+        std::apply([](auto&... column) { (grow_if_full(column), ...); }, columns_);
+
+        size_t appended = 0;
+        try
+        {
+            ((std::get<Is>(columns_).emplace_back(std::forward<TArgs>(args)), ++appended), ...);
+        }
+        catch (...)
+        {
+            ((Is < appended ? std::get<Is>(columns_).pop_back() : void()), ...);
+            throw;
+        }
+    }
+
+    template <typename TColumn>
+    static void grow_if_full(TColumn& column)
+    {
+        if (column.size() == column.capacity())
+            column.reserve(std::max<size_t>(2 * column.size(), 1));
+    }
+};
+
+// select<I...> of records - a view of columns, not a copy
+template <size_t... Is, typename... Ts>
+auto select(SoaVector<Ts...>& records) noexcept
+{
+    return records.template select<Is...>();
+}
+
+template <size_t... Is, typename... Ts>
+auto select(const SoaVector<Ts...>& records) noexcept
+{
+    return records.template select<Is...>();
+}
+
+#endif // SOA_VECTOR_HPP
@@ -0,0 +1,235 @@
+#ifndef STATIC_MAP_HPP
+#define STATIC_MAP_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+/////////////////////////////////////////////////////////////////
+// StaticMap - perfect hash map for a fixed set of string keys
+//
+// Built at compile time with "hash and displace": keys are first hashed
+// into N buckets, then every bucket gets its own seed (or a direct slot
+// for single-key buckets) so that all keys land in distinct slots.
+// A lookup is one hash of a key and one key comparison.
+//
+namespace Detail
+{
+    // little-endian load of up to 8 chars - shifts instead of memcpy to stay constexpr
+    constexpr uint64_t load_word(const char* text, size_t length) noexcept
+    {
+        uint64_t word = 0;
+
+        for (size_t i = 0; i < length; ++i)
+            word |= static_cast<uint64_t>(static_cast<unsigned char>(text[i])) << (8 * i);
+
+        return word;
+    }
+
+    // multiply-xorshift over 8-byte words
+    constexpr uint32_t hash(std::string_view key) noexcept
+    {
+        uint64_t hash = 0x9e3779b97f4a7c15ull ^ key.size();
+
+        size_t i = 0;
+        for (; i + 8 <= key.size(); i += 8)
+        {
+            hash = (hash ^ load_word(key.data() + i, 8)) * 0xff51afd7ed558ccdull;
+            hash ^= hash >> 32;
+        }
+
+        if (i < key.size())
+        {
+            hash = (hash ^ load_word(key.data() + i, key.size() - i)) * 0xff51afd7ed558ccdull;
+            hash ^= hash >> 32;
+        }
+
+        return static_cast<uint32_t>(hash);
+    }
+
+    // seeded murmur3 finalizer - a key is hashed once, every seed remixes the hash
+    constexpr uint32_t mix(uint32_t hash, uint32_t seed) noexcept
+    {
+        hash ^= seed * 0x9e3779b9u;
+        hash ^= hash >> 16;
+        hash *= 0x85ebca6bu;
+        hash ^= hash >> 13;
+        hash *= 0xc2b2ae35u;
+        hash ^= hash >> 16;
+
+        return hash;
+    }
+}
+
+template <typename V, size_t N>
+class StaticMap
+{
+public:
+    using key_type = std::string_view;
+    using mapped_type = V;
+    using value_type = std::pair<std::string_view, V>;
+    using const_iterator = typename std::array<value_type, N>::const_iterator;
+
+    constexpr explicit StaticMap(const value_type (&items)[N])
+    {
+        static_assert(N > 0, "StaticMap can not be empty");
+
+        for (size_t i = 0; i < N; ++i)
+            for (size_t j = 0; j < i; ++j)
+                if (items[i].first == items[j].first)
+                    throw std::logic_error("duplicated key");
+
+        // keys in buckets
+        std::array<uint32_t, N> hashes {};
+        std::array<size_t, N> bucket_of {};
+        std::array<size_t, N> bucket_size {};
+        for (size_t i = 0; i < N; ++i)
+        {
+            hashes[i] = Detail::hash(items[i].first);
+            bucket_of[i] = bucket(hashes[i]);
+            ++bucket_size[bucket_of[i]];
+        }
+
+        // largest buckets are placed first - while the table is mostly empty
+        std::array<size_t, N> buckets {};
+        for (size_t b = 0; b < N; ++b)
+        {
+            size_t pos = b;
+            for (; pos > 0 && bucket_size[buckets[pos - 1]] < bucket_size[b]; --pos)
+                buckets[pos] = buckets[pos - 1];
+            buckets[pos] = b;
+        }
+
+        std::array<bool, N> used {};
+        size_t next_free = 0;
+
+        for (size_t b : buckets)
+        {
+            if (bucket_size[b] == 0)
+                break;
+
+            if (bucket_size[b] == 1)
+            {
+                while (used[next_free])
+                    ++next_free;
+
+                const size_t key_index = find_key_in_bucket(bucket_of, b, 0);
+                place(items[key_index], next_free, used);
+                displacements_[b] = -static_cast<int64_t>(next_free) - 1;
+                continue;
+            }
+
+            for (uint32_t seed = 1;; ++seed)
+            {
+                if (seed == max_seed)
+                    throw std::logic_error("perfect hash not found");
+
+                std::array<size_t, N> slots {};
+                bool collision = false;
+
+                for (size_t k = 0; k < bucket_size[b] && !collision; ++k)
+                {
+                    slots[k] = slot(hashes[find_key_in_bucket(bucket_of, b, k)], seed);
+                    collision = used[slots[k]];
+                    for (size_t j = 0; j < k && !collision; ++j)
+                        collision = slots[j] == slots[k];
+                }
+
+                if (!collision)
+                {
+                    for (size_t k = 0; k < bucket_size[b]; ++k)
+                        place(items[find_key_in_bucket(bucket_of, b, k)], slots[k], used);
+                    displacements_[b] = seed;
+                    break;
+                }
+            }
+        }
+    }
+
+    // returns nullptr if a key is not found
+    constexpr const V* find(std::string_view key) const noexcept
+    {
+        const value_type& item = slots_[find_slot(key)];
+        return item.first == key ? &item.second : nullptr;
+    }
+
+    constexpr bool contains(std::string_view key) const noexcept
+    {
+        return find(key) != nullptr;
+    }
+
+    constexpr const V& at(std::string_view key) const
+    {
+        const V* value = find(key);
+        return value ? *value : throw std::out_of_range("key not found");
+    }
+
+    constexpr size_t size() const noexcept
+    {
+        return N;
+    }
+
+    constexpr const_iterator begin() const noexcept
+    {
+        return slots_.begin();
+    }
+
+    constexpr const_iterator end() const noexcept
+    {
+        return slots_.end();
+    }
+
+private:
+    static constexpr uint32_t max_seed = 100'000;
+
+    std::array<value_type, N> slots_ {};
+    std::array<int64_t, N> displacements_ {}; // seed (> 0) or -(slot + 1) for single-key buckets
+
+    static constexpr size_t bucket(uint32_t hash) noexcept
+    {
+        return Detail::mix(hash, 0) % N;
+    }
+
+    static constexpr size_t slot(uint32_t hash, uint32_t seed) noexcept
+    {
+        return Detail::mix(hash, seed) % N;
+    }
+
+    constexpr size_t find_slot(std::string_view key) const noexcept
+    {
+        const uint32_t hash = Detail::hash(key);
+        const int64_t displacement = displacements_[bucket(hash)];
+
+        return displacement < 0
+            ? static_cast<size_t>(-displacement - 1)
+            : slot(hash, static_cast<uint32_t>(displacement));
+    }
+
+    // index of k-th key in bucket b
+    static constexpr size_t find_key_in_bucket(const std::array<size_t, N>& bucket_of, size_t b, size_t k) noexcept
+    {
+        for (size_t i = 0;; ++i)
+        {
+            if (bucket_of[i] == b && k-- == 0)
+                return i;
+        }
+    }
+
+    constexpr void place(const value_type& item, size_t slot, std::array<bool, N>& used)
+    {
+        slots_[slot].first = item.first;
+        slots_[slot].second = item.second;
+        used[slot] = true;
+    }
+};
+
+template <typename V, size_t N>
+constexpr StaticMap<V, N> make_static_map(const std::pair<std::string_view, V> (&items)[N])
+{
+    return StaticMap<V, N>(items);
+}
+
+#endif // STATIC_MAP_HPP
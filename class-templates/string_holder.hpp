@@ -0,0 +1,233 @@
+#ifndef STRING_HOLDER_HPP
+#define STRING_HOLDER_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <ostream>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+/////////////////////////////////////////////////////////////////
+// StringHolder - string that is either borrowed or owned
+//
+// borrowed - a view of characters owned by someone else (no copy)
+// owned    - up to inline_capacity chars stored inside the object,
+//            longer ones in a heap buffer of an exact size
+//
+// A length is stored, so value() never scans for a terminator. A view of
+// an owned string is free (view()), a borrowed string is copied only
+// when it has to outlive its source (make_owned()).
+//
+class StringHolder
+{
+public:
+    static constexpr size_t inline_capacity = 24;
+
+    enum class Mode : uint8_t
+    {
+        borrowed,
+        inline_owned,
+        heap_owned
+    };
+
+private:
+    union
+    {
+        const char* ptr_;
+        char buffer_[inline_capacity];
+    };
+
+    uint32_t size_ = 0;
+    Mode mode_ = Mode::borrowed;
+
+public:
+    StringHolder() noexcept
+        : ptr_ {""}
+    {
+    }
+
+    static StringHolder borrowed(std::string_view text)
+    {
+        StringHolder result;
+        result.ptr_ = text.data();
+        result.size_ = checked_size(text.size());
+        return result;
+    }
+
+    static StringHolder owned(std::string_view text)
+    {
+        StringHolder result;
+        result.size_ = checked_size(text.size());
+
+        if (text.size() <= inline_capacity)
+        {
+            result.mode_ = Mode::inline_owned;
+            std::memcpy(result.buffer_, text.data(), text.size());
+        }
+        else
+        {
+            char* heap = new char[text.size()];
+            std::memcpy(heap, text.data(), text.size());
+            result.ptr_ = heap;
+            result.mode_ = Mode::heap_owned;
+        }
+
+        return result;
+    }
+
+    // copy of a borrowed string is borrowed too - only owned characters are copied
+    StringHolder(const StringHolder& other)
+        : size_ {other.size_}
+        , mode_ {other.mode_}
+    {
+        if (mode_ == Mode::borrowed)
+            ptr_ = other.ptr_;
+        else if (mode_ == Mode::inline_owned)
+            std::memcpy(buffer_, other.buffer_, size_);
+        else
+        {
+            char* heap = new char[size_];
+            std::memcpy(heap, other.ptr_, size_);
+            ptr_ = heap;
+        }
+    }
+
+    StringHolder(StringHolder&& other) noexcept
+    {
+        steal(other);
+    }
+
+    StringHolder& operator=(const StringHolder& other)
+    {
+        if (this != &other)
+            *this = StringHolder {other};
+
+        return *this;
+    }
+
+    // a borrowed view of own characters (a = a.view()) keeps them owned - they are moved to the front of the storage
+    StringHolder& operator=(StringHolder&& other) noexcept
+    {
+        if (this == &other)
+            return *this;
+
+        if (!is_borrowed() && other.is_borrowed() && owns(other.ptr_))
+        {
+            std::memmove(const_cast<char*>(data()), other.ptr_, other.size_);
+            size_ = other.size_;
+            other.ptr_ = "";
+            other.size_ = 0;
+        }
+        else
+        {
+            release();
+            steal(other);
+        }
+
+        return *this;
+    }
+
+    ~StringHolder()
+    {
+        release();
+    }
+
+    const char* data() const noexcept
+    {
+        return mode_ == Mode::inline_owned ? buffer_ : ptr_;
+    }
+
+    size_t size() const noexcept
+    {
+        return size_;
+    }
+
+    std::string_view value() const noexcept
+    {
+        return std::string_view {data(), size_};
+    }
+
+    Mode mode() const noexcept
+    {
+        return mode_;
+    }
+
+    bool is_borrowed() const noexcept
+    {
+        return mode_ == Mode::borrowed;
+    }
+
+    // borrowed view of the same characters - valid as long as *this is not changed or destroyed
+    StringHolder view() const noexcept
+    {
+        StringHolder result;
+        result.ptr_ = data();
+        result.size_ = size_;
+        return result;
+    }
+
+    // copies borrowed characters, does nothing for an owned string
+    StringHolder& make_owned()
+    {
+        if (is_borrowed())
+            *this = owned(value());
+
+        return *this;
+    }
+
+    friend bool operator==(const StringHolder& a, const StringHolder& b) noexcept
+    {
+        return a.value() == b.value();
+    }
+
+    friend bool operator!=(const StringHolder& a, const StringHolder& b) noexcept
+    {
+        return !(a == b);
+    }
+
+    friend std::ostream& operator<<(std::ostream& out, const StringHolder& text)
+    {
+        return out << text.value();
+    }
+
+private:
+    static uint32_t checked_size(size_t size)
+    {
+        if (size > UINT32_MAX)
+            throw std::length_error("StringHolder: string too long");
+
+        return static_cast<uint32_t>(size);
+    }
+
+    // ptr points into owned characters (or just past them)
+    bool owns(const char* ptr) const noexcept
+    {
+        const char* first = data();
+        return !std::less<const char*> {}(ptr, first) && !std::less<const char*> {}(first + size_, ptr);
+    }
+
+    void steal(StringHolder& other) noexcept
+    {
+        size_ = other.size_;
+        mode_ = other.mode_;
+
+        if (mode_ == Mode::inline_owned)
+            std::memcpy(buffer_, other.buffer_, size_);
+        else
+            ptr_ = other.ptr_;
+
+        other.ptr_ = "";
+        other.size_ = 0;
+        other.mode_ = Mode::borrowed;
+    }
+
+    void release() noexcept
+    {
+        if (mode_ == Mode::heap_owned)
+            delete[] ptr_;
+    }
+};
+
+#endif // STRING_HOLDER_HPP
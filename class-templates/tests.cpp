@@ -1,10 +1,32 @@
+#include "aligned_array.hpp"
 #include "catch.hpp"
+#include "dynamic_bitset.hpp"
+#include "flat_map.hpp"
+#include "hash_map.hpp"
+#include "holder.hpp"
+#include "holder_array.hpp"
+#include "lock_free_stack.hpp"
+#include "pool_allocator.hpp"
+#include "select.hpp"
+#include "soa_vector.hpp"
+#include "static_map.hpp"
+#include "string_holder.hpp"
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <bitset>
+#include <cstring>
 #include <iostream>
 #include <list>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <random>
 #include <string>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 #include <string_view>
 
@@ -12,151 +34,474 @@ using namespace std;
 using namespace Catch::Matchers;
 
 template <typename T>
-class Holder
+struct Data
 {
-    T item_;
+    Holder<T> value;
+};
 
-public:
-    //typedef T value_type;
-    using value_type = T;
+template <typename T>
+using StringKeyMap = std::map<std::string, T>;
+
+StringKeyMap<int> dict = {{"one", 1}, {"two", 2}};
+
+// built at compile time - no static initialization, no allocations
+constexpr auto static_dict = make_static_map<int>({{"one", 1}, {"two", 2}});
+
+static_assert(static_dict.at("two") == 2);
+
+TEST_CASE("Holder")
+{
+    Holder<int> h1 {42};
+    REQUIRE(h1.value() == 42);
+    h1.info();
+
+    Holder<int>::value_type x = h1.value();
+
+    using HolderString = Holder<string>;
+
+    HolderString h2 {"text"};
+    REQUIRE(h2.value() == "text"s);
+
+    Holder<int*> h3(new int(13));
+    REQUIRE(h3.value() == 13);
+    h3.info();
+
+    Holder<const char*> h4 = "text";
+    h4.info();
+
+    auto h5 = make_holder(7); // Holder<int>
+
+    Holder h6(665); // Holder<int>
+    h6.info();
+
+    Holder h7(new string("text"));
+    h7.info();
+
+    Holder h8("abc");
+    h8.info();
+}
+
+enum class Signal : int
+{
+    red,
+    yellow,
+    green
+};
+
+template <>
+struct PackingTraits<Signal> : EnumPacking<Signal, Signal::green>
+{
+};
 
-    Holder(T& item)
-        : item_ {item}
+TEST_CASE("HolderArray")
+{
+    SECTION("bools are packed into bits")
     {
+        HolderArray<bool> flags(1000);
+        REQUIRE(HolderArray<bool>::bits_per_value == 1);
+        REQUIRE(flags.memory_usage() == 16 * sizeof(uint64_t));
+        REQUIRE(flags.count(true) == 0);
+
+        flags[3] = true;
+        flags[999] = flags[3];
+        REQUIRE(flags[3]);
+        REQUIRE(flags[999]);
+        REQUIRE_FALSE(flags[4]);
+        REQUIRE(flags.count(true) == 2);
+        REQUIRE(flags.count(false) == 998);
+
+        flags.flip();
+        REQUIRE(flags.count(true) == 998);
+
+        flags.fill(true);
+        REQUIRE(flags.count(true) == 1000);
     }
 
-    Holder(T&& item)
-        : item_ {std::move(item)}
+    SECTION("small enums are packed into a few bits")
     {
+        REQUIRE(HolderArray<Signal>::bits_per_value == 2);
+
+        HolderArray<Signal> signals(100, Signal::red);
+        for (size_t i = 0; i < signals.size(); i += 3)
+            signals[i] = Signal::green;
+
+        REQUIRE(signals[0] == Signal::green);
+        REQUIRE(signals[1] == Signal::red);
+        REQUIRE(signals.count(Signal::green) == 34);
+        REQUIRE(signals.count(Signal::red) == 66);
+        REQUIRE(signals.count(Signal::yellow) == 0);
     }
 
-    T& value()
+    SECTION("other integral types keep their width")
     {
-        return item_;
-    }
+        HolderArray<int16_t> numbers;
+        for (int16_t i = -5; i < 5; ++i)
+            numbers.push_back(i);
 
-    const T& value() const;
+        REQUIRE(numbers.size() == 10);
+        REQUIRE(vector<int16_t>(numbers.begin(), numbers.end()) == vector<int16_t> {-5, -4, -3, -2, -1, 0, 1, 2, 3, 4});
+        REQUIRE(numbers.count(-1) == 1);
+    }
 
-    void info() const
+    SECTION("resize keeps values & fills new ones")
     {
-        std::cout << "Holder<T: " << typeid(T).name() << ">(" << item_ << ")\n";
+        HolderArray<uint8_t> bytes(5, 7);
+        bytes.resize(21, 9);
+        REQUIRE(bytes.count(7) == 5);
+        REQUIRE(bytes.count(9) == 16);
+
+        bytes.resize(3);
+        REQUIRE(bytes.count(7) == 3);
+        REQUIRE(bytes.count(0) == 0);
     }
-};
 
-// deduction guide - C++17 (CTAD)
-template <typename T>
-Holder(T) -> Holder<T>;
+    SECTION("memory compared to vector<Holder<bool>>")
+    {
+        const size_t size = 1'000'000;
 
-template <typename T>
-const T& Holder<T>::value() const
-{
-    return item_;
+        vector<Holder<bool>> holders(size, Holder<bool> {false});
+        HolderArray<bool> flags(size);
+
+        REQUIRE(flags.memory_usage() * 8 <= holders.size() * sizeof(Holder<bool>));
+    }
 }
 
-template <typename T>
-class Holder<T*>
+TEST_CASE("HolderArray vs. vector<Holder<bool>> & vector<bool>", "[!benchmark]")
 {
-    std::unique_ptr<T> item_;
-public:
-    using value_type = T;
+    const size_t size = 1'000'000;
 
-    Holder(T* item)
-        : item_ {item}
+    vector<Holder<bool>> holders;
+    vector<bool> bools;
+    HolderArray<bool> flags;
+    for (size_t i = 0; i < size; ++i)
     {
+        const bool value = (i * 2654435761u) % 7 < 3;
+        holders.push_back(Holder<bool> {bool(value)});
+        bools.push_back(value);
+        flags.push_back(value);
     }
 
-    T& value()
+    BENCHMARK("count - vector<Holder<bool>>")
     {
-        return *item_;
-    }
+        return std::count_if(holders.begin(), holders.end(), [](const auto& h) { return h.value(); });
+    };
 
-    const T& value() const
+    BENCHMARK("count - vector<bool>")
     {
-        return *item_;
-    }
+        return std::count(bools.begin(), bools.end(), true);
+    };
+
+    BENCHMARK("count - HolderArray<bool>")
+    {
+        return flags.count(true);
+    };
+
+    BENCHMARK("flip - vector<Holder<bool>>")
+    {
+        for (auto& h : holders)
+            h.value() = !h.value();
+        return holders.size();
+    };
+
+    BENCHMARK("flip - vector<bool>")
+    {
+        bools.flip();
+        return bools.size();
+    };
+
+    BENCHMARK("flip - HolderArray<bool>")
+    {
+        flags.flip();
+        return flags.size();
+    };
+
+    BENCHMARK("random access - vector<bool>")
+    {
+        size_t result = 0;
+        for (size_t i = 0; i < size; i += 7)
+            result += bools[i];
+        return result;
+    };
 
-    T* get() const
+    BENCHMARK("random access - HolderArray<bool>")
+    {
+        size_t result = 0;
+        for (size_t i = 0; i < size; i += 7)
+            result += flags[i];
+        return result;
+    };
+}
+
+template <typename TCountPolicy>
+struct Widget : RefCounted<TCountPolicy>
+{
+    int id;
+    string name;
+
+    Widget(int id, string name)
+        : id {id}
+        , name {std::move(name)}
     {
-        return item_;
     }
 
-    void info() const
+    friend std::ostream& operator<<(std::ostream& out, const Widget& w)
     {
-        std::cout << "Holder<T*: " << typeid(T).name() << ">(" << item_ 
-        << " - " << *item_ << ")\n";
+        return out << "Widget(" << w.id << ", " << w.name << ")";
     }
 };
 
-template <>
-class Holder<const char*>
+TEST_CASE("Holder<T*> - intrusive reference counting")
 {
-    const char* item_;
-public:
-    using value_type = const char*;
+    using SharedWidget = Widget<AtomicCount>;
 
-    Holder(const char* item)
-        : item_ {item}
+    SECTION("objects without counter are owned uniquely")
     {
+        Holder<int*> h(new int(13));
+        REQUIRE(*h.get() == 13);
+        static_assert(!is_copy_constructible_v<Holder<int*>>);
     }
 
-    std::string_view value() const
+    SECTION("ref counted objects are shared")
     {
-        return item_;
+        auto* widget = new SharedWidget {1, "gadget"};
+
+        Holder<SharedWidget*> h1(widget);
+        REQUIRE(widget->ref_count() == 1);
+
+        {
+            Holder<SharedWidget*> h2 = h1;
+            REQUIRE(h2.get() == widget);
+            REQUIRE(widget->ref_count() == 2);
+
+            h2.value().name = "changed";
+        }
+
+        REQUIRE(widget->ref_count() == 1);
+        REQUIRE(h1.value().name == "changed");
+        h1.info();
     }
 
-    void info() const
+    SECTION("copy of an object gets its own counter")
     {
-        std::cout << "Holder<const char*>(" << item_ << ")\n";
+        IntrusivePtr<SharedWidget> p1 {new SharedWidget {1, "a"}};
+        IntrusivePtr<SharedWidget> p2 = p1;
+
+        IntrusivePtr<SharedWidget> p3 {new SharedWidget {*p1}};
+        REQUIRE(p1.use_count() == 2);
+        REQUIRE(p3.use_count() == 1);
+        REQUIRE(p3->name == "a");
     }
-};
 
-template <typename T>
-Holder<T> make_holder(T item)
+    SECTION("non atomic count policy")
+    {
+        IntrusivePtr<Widget<LocalCount>> p1 {new Widget<LocalCount> {2, "local"}};
+        auto p2 = p1;
+        REQUIRE(p2.use_count() == 2);
+
+        p1 = IntrusivePtr<Widget<LocalCount>> {};
+        REQUIRE(p2.use_count() == 1);
+        REQUIRE(sizeof(p2) == sizeof(void*));
+    }
+}
+
+TEST_CASE("IntrusivePtr vs. shared_ptr", "[!benchmark]")
 {
-    return Holder<T>(item);
+    const size_t count = 1000;
+
+    BENCHMARK("create - shared_ptr(new)")
+    {
+        return std::shared_ptr<Widget<AtomicCount>>(new Widget<AtomicCount> {1, "w"});
+    };
+
+    BENCHMARK("create - make_shared")
+    {
+        return std::make_shared<Widget<AtomicCount>>(1, "w");
+    };
+
+    BENCHMARK("create - IntrusivePtr")
+    {
+        return IntrusivePtr<Widget<AtomicCount>>(new Widget<AtomicCount> {1, "w"});
+    };
+
+    // libstdc++ uses non-atomic counters in a process that never started a thread
+    std::thread {[] {}}.join();
+
+    auto shared = std::make_shared<Widget<AtomicCount>>(1, "w");
+    IntrusivePtr<Widget<AtomicCount>> intrusive {new Widget<AtomicCount> {1, "w"}};
+    IntrusivePtr<Widget<LocalCount>> local {new Widget<LocalCount> {1, "w"}};
+
+    BENCHMARK("copy & destroy - shared_ptr")
+    {
+        std::vector<std::shared_ptr<Widget<AtomicCount>>> copies(count, shared);
+        return copies.size();
+    };
+
+    BENCHMARK("copy & destroy - IntrusivePtr<AtomicCount>")
+    {
+        std::vector<IntrusivePtr<Widget<AtomicCount>>> copies(count, intrusive);
+        return copies.size();
+    };
+
+    BENCHMARK("copy & destroy - IntrusivePtr<LocalCount>")
+    {
+        std::vector<IntrusivePtr<Widget<LocalCount>>> copies(count, local);
+        return copies.size();
+    };
 }
 
-template <typename T>
-struct Data
+TEST_CASE("StringHolder")
 {
-    Holder<T> value;
-};
+    const string source = "a rather long identifier of a customer account";
 
-template <typename T>
-using StringKeyMap = std::map<std::string, T>;
+    SECTION("Holder<const char*> keeps a length")
+    {
+        Holder<const char*> h = "text";
+        REQUIRE(h.value() == "text");
+        REQUIRE(h.value().size() == 4);
+    }
 
-StringKeyMap<int> dict = {{"one", 1}, {"two", 2}};
+    SECTION("borrowed string is not copied")
+    {
+        auto text = StringHolder::borrowed(source);
+        REQUIRE(text.is_borrowed());
+        REQUIRE(text.data() == source.data());
+        REQUIRE(text.value() == source);
 
-TEST_CASE("Holder")
+        auto copy = text;
+        REQUIRE(copy.data() == source.data());
+    }
+
+    SECTION("short owned strings are stored inline")
+    {
+        static_assert(sizeof(StringHolder) == 32);
+
+        string id = "customer_account_12345";
+        auto text = StringHolder::owned(id);
+        id.clear();
+
+        REQUIRE(text.mode() == StringHolder::Mode::inline_owned);
+        REQUIRE(text.value() == "customer_account_12345");
+
+        auto moved = std::move(text);
+        REQUIRE(moved.value() == "customer_account_12345");
+        REQUIRE(text.value().empty());
+    }
+
+    SECTION("long owned strings are stored on heap")
+    {
+        auto text = StringHolder::owned(source);
+        REQUIRE(text.mode() == StringHolder::Mode::heap_owned);
+
+        const char* data = text.data();
+        auto moved = std::move(text);
+        REQUIRE(moved.data() == data);
+
+        auto copy = moved;
+        REQUIRE(copy.data() != data);
+        REQUIRE(copy == moved);
+    }
+
+    SECTION("conversions between modes")
+    {
+        auto owned = StringHolder::owned(source);
+        auto view = owned.view();
+        REQUIRE(view.is_borrowed());
+        REQUIRE(view.data() == owned.data());
+
+        view.make_owned();
+        REQUIRE(view.mode() == StringHolder::Mode::heap_owned);
+        REQUIRE(view.data() != owned.data());
+        REQUIRE(view == owned);
+    }
+
+    SECTION("assignment of a view of own characters")
+    {
+        auto text = StringHolder::owned(source);
+        text = text.view();
+        REQUIRE(text.mode() == StringHolder::Mode::heap_owned);
+        REQUIRE(text.value() == source);
+
+        text = StringHolder::borrowed(text.value().substr(9));
+        REQUIRE(text.value() == source.substr(9));
+
+        auto id = StringHolder::owned("id_42");
+        id = StringHolder::borrowed(id.value().substr(3));
+        REQUIRE(id.mode() == StringHolder::Mode::inline_owned);
+        REQUIRE(id.value() == "42");
+    }
+
+    SECTION("Holder of StringHolder")
+    {
+        Holder<StringHolder> h {StringHolder::borrowed("text")};
+        REQUIRE(h.value().value() == "text");
+        h.info();
+    }
+}
+
+TEST_CASE("StringHolder vs. std::string", "[!benchmark]")
 {
-    Holder<int> h1 {42};
-    REQUIRE(h1.value() == 42);
-    h1.info();
+    const size_t count = 1'000'000;
 
-    Holder<int>::value_type x = h1.value();
+    std::string identifiers;
+    std::vector<std::string_view> views;
+    {
+        std::vector<size_t> offsets;
+        for (size_t i = 0; i < count; ++i)
+        {
+            offsets.push_back(identifiers.size());
+            identifiers += (i % 2 ? "customer_account_" : "id_") + std::to_string(i);
+        }
+        offsets.push_back(identifiers.size());
 
-    using HolderString = Holder<string>;
+        for (size_t i = 0; i < count; ++i)
+            views.emplace_back(identifiers.data() + offsets[i], offsets[i + 1] - offsets[i]);
+    }
 
-    HolderString h2 {"text"};
-    REQUIRE(h2.value() == "text"s);
+    std::vector<std::string> c_strings(views.begin(), views.end());
 
-    Holder<int*> h3(new int(13));
-    REQUIRE(h3.value() == 13);
-    h3.info();
+    BENCHMARK("copy - vector<std::string>")
+    {
+        std::vector<std::string> result(views.begin(), views.end());
+        return result.size();
+    };
 
-    Holder<const char*> h4 = "text";
-    h4.info();
+    BENCHMARK("copy - vector<StringHolder> owned")
+    {
+        std::vector<StringHolder> result;
+        result.reserve(views.size());
+        for (auto v : views)
+            result.push_back(StringHolder::owned(v));
+        return result.size();
+    };
 
-    auto h5 = make_holder(7); // Holder<int>
+    BENCHMARK("copy - vector<StringHolder> borrowed")
+    {
+        std::vector<StringHolder> result;
+        result.reserve(views.size());
+        for (auto v : views)
+            result.push_back(StringHolder::borrowed(v));
+        return result.size();
+    };
 
-    Holder h6(665); // Holder<int>
-    h6.info();
+    std::vector<Holder<const char*>> holders;
+    for (const auto& s : c_strings)
+        holders.emplace_back(s.c_str());
 
-    Holder h7(new string("text"));
-    h7.info();
+    BENCHMARK("length - Holder<const char*>")
+    {
+        size_t total = 0;
+        for (const auto& h : holders)
+            total += h.value().size();
+        return total;
+    };
 
-    Holder h8("abc");
-    h8.info();
+    BENCHMARK("length - strlen")
+    {
+        size_t total = 0;
+        for (const auto& s : c_strings)
+            total += std::strlen(s.c_str());
+        return total;
+    };
 }
 
 TEST_CASE("CTAD - std")
@@ -166,41 +511,124 @@ TEST_CASE("CTAD - std")
     array tab = {1, 2, 3};
 }
 
-template <typename T, size_t N>
-struct Array
+TEST_CASE("Array")
 {
-    T items[N];
+    std::array<int, 8> arr1 = {1, 2, 3, 4};
+    for (size_t i = 0; i < arr1.size(); ++i)
+        std::cout << arr1[i] << " ";
+    std::cout << "\n";
 
-    using value_type = T;
+    std::bitset<16> bs1(1256);
+    std::cout << bs1 << std::endl;
 
-    size_t size() const noexcept
+    tuple<int, double, string> tpl(1, 3.14, "text");
+    REQUIRE(select<0, 2>(tpl) == tuple<int, string>(1, "text"));
+}
+
+TEST_CASE("aligned Array")
+{
+    SECTION("typed access")
     {
-        return N;
+        Array<double, 4> arr = {{1.5, 2.5, 3.5, 4.5}};
+        static_assert(is_same_v<decltype(arr[0]), double&>);
+
+        arr[1] = 0.25;
+        REQUIRE(arr[1] == 0.25);
+        REQUIRE(arr.size() == 4);
     }
 
-    int& operator[](size_t index) noexcept
+    SECTION("aligned for vector registers")
     {
-        return items[index];
+        static_assert(alignof(Array<float, 8>) == 32);
+        static_assert(alignof(Array<float, 2>) == alignof(float));
+        static_assert(alignof(Array<double, 1024>) == 32);
     }
 
-    const int& operator[](size_t index) const noexcept
+    SECTION("element-wise arithmetic")
     {
-        return items[index];
+        constexpr Array<int, 4> a = {{1, 2, 3, 4}};
+        constexpr Array<int, 4> b = {{5, 6, 7, 8}};
+
+        static_assert(a + b == Array<int, 4> {{6, 8, 10, 12}});
+        static_assert(b - a == Array<int, 4> {{4, 4, 4, 4}});
+        static_assert(a * b == Array<int, 4> {{5, 12, 21, 32}});
+        static_assert(2 * a == Array<int, 4> {{2, 4, 6, 8}});
+        static_assert(multiply_add(a, b, a) == a * b + a);
+
+        auto c = a;
+        c += b;
+        c *= 2;
+        REQUIRE(c == Array<int, 4> {{12, 16, 20, 24}});
     }
-};
 
-TEST_CASE("Array")
+    SECTION("reductions")
+    {
+        constexpr Array<int, 4> a = {{1, 2, 3, 4}};
+        static_assert(sum(a) == 10);
+        static_assert(dot(a, a) == 30);
+
+        Array<double, 1001> x {};
+        for (size_t i = 0; i < x.size(); ++i)
+            x[i] = static_cast<double>(i);
+
+        REQUIRE(sum(x) == 500'500.0);
+        REQUIRE(dot(x, x) == std::inner_product(x.begin(), x.end(), x.begin(), 0.0));
+    }
+}
+
+TEST_CASE("aligned Array vs. std::array loops", "[!benchmark]")
 {
-    std::array<int, 8> arr1 = {1, 2, 3, 4};
-    for (size_t i = 0; i < arr1.size(); ++i)
-        std::cout << arr1[i] << " ";
-    std::cout << "\n";
+    constexpr size_t N = 1024;
 
-    std::bitset<16> bs1(1256);
-    std::cout << bs1 << std::endl;
+    std::array<float, N> a1, b1, c1;
+    Array<float, N> a2, b2, c2;
+    for (size_t i = 0; i < N; ++i)
+    {
+        a1[i] = a2[i] = static_cast<float>(i % 17) * 0.5f;
+        b1[i] = b2[i] = static_cast<float>(i % 5) * 0.25f;
+        c1[i] = c2[i] = 1.0f;
+    }
+
+    BENCHMARK("a * b + c - std::array loop")
+    {
+        std::array<float, N> result;
+        for (size_t i = 0; i < N; ++i)
+            result[i] = a1[i] * b1[i] + c1[i];
+        return result;
+    };
+
+    BENCHMARK("a * b + c - Array")
+    {
+        return a2 * b2 + c2;
+    };
+
+    BENCHMARK("a * b + c - multiply_add")
+    {
+        return multiply_add(a2, b2, c2);
+    };
+
+    BENCHMARK("dot - std::array loop")
+    {
+        float result = 0.0f;
+        for (size_t i = 0; i < N; ++i)
+            result += a1[i] * b1[i];
+        return result;
+    };
+
+    BENCHMARK("dot - Array")
+    {
+        return dot(a2, b2);
+    };
+
+    BENCHMARK("sum - std::accumulate")
+    {
+        return std::accumulate(a1.begin(), a1.end(), 0.0f);
+    };
 
-    // tuple<int, double, string> tpl(1, 3.14, "text");
-    // REQUIRE(select<0, 2>(tpl) == tuple<int, string>(1, "text");
+    BENCHMARK("sum - Array")
+    {
+        return sum(a2);
+    };
 }
 
 namespace ver1
@@ -217,17 +645,127 @@ namespace ver1
     };
 }
 
-template <typename T, template<typename, typename> class Container, typename A = std::allocator<T>>
-struct Stack
+template <typename T, typename = void>
+struct HasTryPop : std::false_type
 {
-    Container<T, A> items;
+};
 
-    void push(const T& item)
-    {
+template <typename T>
+struct HasTryPop<T, std::void_t<decltype(std::declval<T&>().try_pop(std::declval<typename T::value_type&>()))>> : std::true_type
+{
+};
+
+template <typename T, template<typename, typename> class Container, typename A = std::allocator<T>>
+struct Stack
+{
+    Container<T, A> items;
+
+    void push(const T& item)
+    {
         items.push_back(item);
     }
+
+    void push(T&& item)
+    {
+        items.push_back(std::move(item));
+    }
+
+    // concurrent containers (LockFreeStack) pop atomically - others are used back & pop_back
+    bool try_pop(T& item)
+    {
+        if constexpr (HasTryPop<Container<T, A>>::value)
+        {
+            return items.try_pop(item);
+        }
+        else
+        {
+            if (items.empty())
+                return false;
+
+            item = std::move(items.back());
+            items.pop_back();
+            return true;
+        }
+    }
+
+    bool empty() const
+    {
+        return items.empty();
+    }
+};
+
+// std::vector behind a mutex - a baseline for LockFreeStack
+template <typename T, typename A = std::allocator<T>>
+class LockedVector
+{
+    std::vector<T, A> items_;
+    mutable std::mutex mtx_;
+
+public:
+    using value_type = T;
+
+    void push_back(const T& item)
+    {
+        std::lock_guard lk {mtx_};
+        items_.push_back(item);
+    }
+
+    bool try_pop(T& item)
+    {
+        std::lock_guard lk {mtx_};
+
+        if (items_.empty())
+            return false;
+
+        item = std::move(items_.back());
+        items_.pop_back();
+        return true;
+    }
+
+    bool empty() const
+    {
+        std::lock_guard lk {mtx_};
+        return items_.empty();
+    }
 };
 
+// producers push items_per_producer numbers each, consumers pop until all are popped - returns a sum of popped items
+template <typename TStack>
+long long run_producers_consumers(TStack& stack, int producers, int consumers, int items_per_producer)
+{
+    std::atomic<long long> total {0};
+    std::atomic<int> remaining {producers * items_per_producer};
+    std::vector<std::thread> threads;
+
+    for (int p = 0; p < producers; ++p)
+        threads.emplace_back([&, p] {
+            for (int i = 0; i < items_per_producer; ++i)
+                stack.push(p * items_per_producer + i);
+        });
+
+    for (int c = 0; c < consumers; ++c)
+        threads.emplace_back([&] {
+            long long sum = 0;
+            int item;
+            while (remaining.load(std::memory_order_relaxed) > 0)
+            {
+                if (stack.try_pop(item))
+                {
+                    sum += item;
+                    remaining.fetch_sub(1, std::memory_order_relaxed);
+                }
+                else
+                    std::this_thread::yield();
+            }
+            total += sum;
+        });
+
+    for (auto& t : threads)
+        t.join();
+
+    return total;
+}
+
 TEST_CASE("Stack")
 {
     ver1::Stack<int, std::list<int>> s0;
@@ -239,4 +777,1026 @@ TEST_CASE("Stack")
     
     vector<bool> flags = {0, 1, 1, 0};
     flags.flip();
-}
\ No newline at end of file
+}
+
+TEST_CASE("LockFreeStack")
+{
+    SECTION("LIFO order through Stack interface")
+    {
+        Stack<int, LockFreeStack> stack;
+        REQUIRE(stack.empty());
+
+        for (int i = 0; i < 100; ++i)
+            stack.push(i);
+
+        int item;
+        for (int i = 99; i >= 0; --i)
+        {
+            REQUIRE(stack.try_pop(item));
+            REQUIRE(item == i);
+        }
+
+        REQUIRE_FALSE(stack.try_pop(item));
+        REQUIRE(stack.empty());
+    }
+
+    SECTION("standard containers get pop too")
+    {
+        Stack<string, std::vector> stack;
+        stack.push("a");
+        stack.push("b");
+
+        string item;
+        REQUIRE(stack.try_pop(item));
+        REQUIRE(item == "b");
+    }
+
+    SECTION("nodes are reused")
+    {
+        LockFreeStack<string> stack;
+
+        string item;
+        for (int round = 0; round < 1000; ++round)
+        {
+            for (int i = 0; i < 10; ++i)
+                stack.push(to_string(i));
+            while (stack.try_pop(item))
+                ;
+        }
+
+        REQUIRE(stack.capacity() == 10);
+    }
+
+    SECTION("items left in a stack are destroyed")
+    {
+        auto item = std::make_shared<int>(1);
+        {
+            LockFreeStack<std::shared_ptr<int>> stack;
+            stack.push(item);
+            stack.push(item);
+            REQUIRE(item.use_count() == 3);
+        }
+        REQUIRE(item.use_count() == 1);
+    }
+
+    SECTION("many producers & consumers")
+    {
+        const int producers = 4, consumers = 4, items_per_producer = 20'000;
+        const long long n = producers * items_per_producer;
+
+        Stack<int, LockFreeStack> stack;
+        REQUIRE(run_producers_consumers(stack, producers, consumers, items_per_producer) == n * (n - 1) / 2);
+        REQUIRE(stack.empty());
+    }
+}
+
+TEST_CASE("PoolAllocator")
+{
+    SECTION("freed blocks are reused")
+    {
+        Arena arena;
+        PoolAllocator<double> allocator {arena};
+
+        double* first = allocator.allocate(1);
+        allocator.deallocate(first, 1);
+        REQUIRE(allocator.allocate(1) == first);
+        REQUIRE(arena.bytes_reserved() == 64 * 1024);
+    }
+
+    SECTION("Stack<T, std::list>")
+    {
+        Arena arena;
+        Stack<int, std::list, PoolAllocator<int>> stack {std::list<int, PoolAllocator<int>> {PoolAllocator<int> {arena}}};
+        for (int i = 0; i < 10'000; ++i)
+            stack.push(i);
+
+        int item;
+        REQUIRE(stack.try_pop(item));
+        REQUIRE(item == 9'999);
+    }
+
+    SECTION("std::map - node type is rebound")
+    {
+        Arena arena;
+        {
+            std::map<int, string, std::less<>, PoolAllocator<std::pair<const int, string>>> dict {PoolAllocator<int> {arena}};
+            for (int i = 0; i < 1000; ++i)
+                dict.emplace(i, to_string(i));
+
+            REQUIRE(dict.at(665) == "665");
+            REQUIRE(dict.get_allocator().arena().bytes_reserved() > 0);
+        }
+
+        arena.release();
+        REQUIRE(arena.bytes_reserved() == 0);
+    }
+
+    SECTION("allocator moves with nodes")
+    {
+        static_assert(!std::is_default_constructible_v<PoolAllocator<int>>);
+
+        Arena arena1;
+        Arena arena2;
+        std::list<int, PoolAllocator<int>> list1({1, 2, 3}, PoolAllocator<int> {arena1});
+        std::list<int, PoolAllocator<int>> list2({4, 5}, PoolAllocator<int> {arena2});
+
+        list2 = std::move(list1);
+        REQUIRE(&list2.get_allocator().arena() == &arena1);
+        REQUIRE(list2 == std::list<int, PoolAllocator<int>>({1, 2, 3}, PoolAllocator<int> {arena1}));
+
+        list1 = list2;
+        REQUIRE(&list1.get_allocator().arena() == &arena1);
+
+        std::list<int, PoolAllocator<int>> list3({6}, PoolAllocator<int> {arena2});
+        swap(list1, list3);
+        REQUIRE(&list1.get_allocator().arena() == &arena2);
+        REQUIRE(&list3.get_allocator().arena() == &arena1);
+    }
+}
+
+TEST_CASE("PoolAllocator vs. std::allocator", "[!benchmark]")
+{
+    const int n = 100'000;
+
+    BENCHMARK("Stack<int, std::list> push & pop - std::allocator")
+    {
+        Stack<int, std::list> stack;
+        for (int i = 0; i < n; ++i)
+            stack.push(i);
+
+        long long sum = 0;
+        int item;
+        while (stack.try_pop(item))
+            sum += item;
+        return sum;
+    };
+
+    Arena arena;
+
+    BENCHMARK("Stack<int, std::list> push & pop - PoolAllocator")
+    {
+        Stack<int, std::list, PoolAllocator<int>> stack {std::list<int, PoolAllocator<int>> {PoolAllocator<int> {arena}}};
+        for (int i = 0; i < n; ++i)
+            stack.push(i);
+
+        long long sum = 0;
+        int item;
+        while (stack.try_pop(item))
+            sum += item;
+        return sum;
+    };
+
+    BENCHMARK("std::map insert & erase - std::allocator")
+    {
+        std::map<int, int> dict;
+        for (int i = 0; i < n; ++i)
+            dict.emplace(i * 7 % n, i);
+        for (int i = 0; i < n; ++i)
+            dict.erase(i);
+        return dict.size();
+    };
+
+    BENCHMARK("std::map insert & erase - PoolAllocator")
+    {
+        std::map<int, int, std::less<int>, PoolAllocator<std::pair<const int, int>>> dict {PoolAllocator<int> {arena}};
+        for (int i = 0; i < n; ++i)
+            dict.emplace(i * 7 % n, i);
+        for (int i = 0; i < n; ++i)
+            dict.erase(i);
+        return dict.size();
+    };
+}
+
+TEST_CASE("LockFreeStack vs. mutex & vector", "[!benchmark]")
+{
+    const int items_per_producer = 100'000;
+
+    for (int threads : {1, 2, 4})
+    {
+        const string suffix = " - " + to_string(threads) + " producers & consumers";
+
+        BENCHMARK("LockedVector" + suffix)
+        {
+            Stack<int, LockedVector> stack;
+            return run_producers_consumers(stack, threads, threads, items_per_producer);
+        };
+
+        BENCHMARK("LockFreeStack" + suffix)
+        {
+            Stack<int, LockFreeStack> stack;
+            return run_producers_consumers(stack, threads, threads, items_per_producer);
+        };
+    }
+}
+
+constexpr std::pair<std::string_view, int> config_items[] = {
+    {"threads", 8}, {"queue_size", 1024}, {"timeout_ms", 250}, {"retries", 3},
+    {"port", 8080}, {"backlog", 128}, {"log_level", 2}, {"buffer_size", 4096},
+    {"max_connections", 10000}, {"keep_alive_s", 60}, {"cache_size_mb", 512}, {"compression", 1},
+    {"batch_size", 64}, {"flush_interval_ms", 100}, {"max_payload_kb", 256}, {"workers", 4},
+    {"shards", 16}, {"replicas", 3}, {"heartbeat_ms", 500}, {"gc_interval_s", 30},
+    {"read_timeout_ms", 1000}, {"write_timeout_ms", 1000}, {"max_retries_backoff_ms", 5000}, {"ttl_s", 3600},
+    {"prefetch", 32}, {"io_depth", 64}, {"page_size", 4096}, {"journal_mode", 1},
+    {"sync_mode", 2}, {"checkpoint_s", 300}, {"metrics_port", 9090}, {"debug", 0}};
+
+TEST_CASE("StaticMap")
+{
+    constexpr auto config = make_static_map(config_items);
+
+    static_assert(config.size() == 32);
+    static_assert(config.at("threads") == 8);
+    static_assert(config.at("debug") == 0);
+    static_assert(!config.contains("thread"));
+
+    SECTION("every key is found")
+    {
+        for (const auto& [key, value] : config_items)
+        {
+            REQUIRE(config.contains(key));
+            REQUIRE(config.at(key) == value);
+        }
+    }
+
+    SECTION("unknown keys")
+    {
+        REQUIRE(config.find("") == nullptr);
+        REQUIRE(config.find("threads ") == nullptr);
+        REQUIRE_THROWS_AS(config.at("unknown"), std::out_of_range);
+    }
+
+    SECTION("lookup with std::string")
+    {
+        std::string key = "metrics_port";
+        REQUIRE(*config.find(key) == 9090);
+    }
+
+    SECTION("iteration")
+    {
+        int total = 0;
+        for (const auto& item : config)
+            total += item.second;
+
+        REQUIRE(total == std::accumulate(std::begin(config_items), std::end(config_items), 0,
+                             [](int sum, const auto& item) { return sum + item.second; }));
+    }
+}
+
+TEST_CASE("StaticMap vs. std::map & std::unordered_map", "[!benchmark]")
+{
+    constexpr auto static_config = make_static_map(config_items);
+    const StringKeyMap<int> map_config(std::begin(config_items), std::end(config_items));
+    const std::unordered_map<std::string, int> hash_config(std::begin(config_items), std::end(config_items));
+
+    std::vector<std::string> keys;
+    for (int i = 0; i < 1000; ++i)
+        keys.emplace_back(config_items[(i * 7) % std::size(config_items)].first);
+
+    BENCHMARK("std::map<std::string, int>")
+    {
+        int total = 0;
+        for (const auto& key : keys)
+            total += map_config.find(key)->second;
+        return total;
+    };
+
+    BENCHMARK("std::unordered_map<std::string, int>")
+    {
+        int total = 0;
+        for (const auto& key : keys)
+            total += hash_config.find(key)->second;
+        return total;
+    };
+
+    BENCHMARK("StaticMap<int, 32>")
+    {
+        int total = 0;
+        for (const auto& key : keys)
+            total += *static_config.find(key);
+        return total;
+    };
+}
+
+TEST_CASE("FlatMap")
+{
+    SECTION("replacement of StringKeyMap")
+    {
+        FlatStringKeyMap<int> flat_dict = {{"two", 2}, {"one", 1}, {"three", 3}};
+
+        REQUIRE(flat_dict.size() == 3);
+        REQUIRE(flat_dict.at("two") == 2);
+        REQUIRE(flat_dict["four"] == 0);
+        flat_dict["four"] = 4;
+
+        vector<string> keys;
+        for (const auto& [key, value] : flat_dict)
+            keys.push_back(key);
+        REQUIRE(keys == vector<string> {"four", "one", "three", "two"});
+    }
+
+    SECTION("heterogeneous lookup")
+    {
+        FlatStringKeyMap<int> flat_dict = {{"one", 1}};
+        const string_view key = "one";
+
+        auto it = flat_dict.find(key);
+        REQUIRE(it != flat_dict.end());
+        REQUIRE(it->second == 1);
+        it->second = 11;
+        REQUIRE(flat_dict.at("one") == 11);
+
+        REQUIRE(flat_dict.find("zero"sv) == flat_dict.end());
+        REQUIRE_THROWS_AS(flat_dict.at("zero"), std::out_of_range);
+    }
+
+    SECTION("bulk build from unsorted input - first of duplicates wins")
+    {
+        vector<pair<string, int>> items = {{"b", 2}, {"a", 1}, {"c", 3}, {"a", 10}};
+        FlatMap<string, int> flat_dict(items.begin(), items.end());
+
+        REQUIRE(flat_dict.keys() == vector<string> {"a", "b", "c"});
+        REQUIRE(flat_dict.values() == vector<int> {1, 2, 3});
+    }
+
+    SECTION("insert & erase keep keys sorted")
+    {
+        FlatMap<string, int> flat_dict;
+        REQUIRE(flat_dict.try_emplace("b", 2).second);
+        REQUIRE(flat_dict.insert({"a", 1}).second);
+        REQUIRE_FALSE(flat_dict.insert({"a", 100}).second);
+        REQUIRE(flat_dict.insert_or_assign("c", 3).second);
+        REQUIRE_FALSE(flat_dict.insert_or_assign("a", 0).second);
+
+        REQUIRE(flat_dict.keys() == vector<string> {"a", "b", "c"});
+        REQUIRE(flat_dict.values() == vector<int> {0, 2, 3});
+
+        REQUIRE(flat_dict.erase("b"sv) == 1);
+        REQUIRE(flat_dict.erase("b"sv) == 0);
+        REQUIRE(flat_dict.keys() == vector<string> {"a", "c"});
+    }
+
+    SECTION("rows are proxies - values are assignable through auto")
+    {
+        FlatMap<string, int> flat_dict = {{"a", 1}, {"b", 2}};
+        for (auto [key, value] : flat_dict)
+            value *= 10;
+
+        REQUIRE(flat_dict.values() == vector<int> {10, 20});
+    }
+
+    SECTION("random access iterators")
+    {
+        const FlatMap<int, int> flat_dict = {{1, 10}, {2, 20}, {3, 30}, {4, 40}};
+
+        auto first = flat_dict.begin();
+        auto last = flat_dict.end();
+        REQUIRE(last - first == 4);
+        REQUIRE((last - 1)->second == 40);
+        REQUIRE((2 + first)->first == 3);
+        REQUIRE(first[1].second == 20);
+        REQUIRE(first < last);
+        REQUIRE(last >= first);
+        REQUIRE_FALSE(first > first);
+
+        auto it = last;
+        it -= 2;
+        REQUIRE(it->first == 3);
+        REQUIRE((it--)->first == 3);
+        REQUIRE(it->first == 2);
+
+        REQUIRE(std::partition_point(first, last, [](const auto& row) { return row.first < 3; }) - first == 2);
+    }
+
+    SECTION("throwing value constructor leaves keys & values aligned")
+    {
+        struct Throwing
+        {
+            explicit Throwing(int value)
+            {
+                if (value < 0)
+                    throw std::invalid_argument("negative");
+            }
+        };
+
+        FlatMap<int, Throwing> flat_dict;
+        flat_dict.try_emplace(1, 1);
+        REQUIRE_THROWS_AS(flat_dict.try_emplace(0, -1), std::invalid_argument);
+
+        REQUIRE(flat_dict.keys() == vector<int> {1});
+        REQUIRE(flat_dict.values().size() == 1);
+    }
+}
+
+TEST_CASE("FlatMap vs. std::map", "[!benchmark]")
+{
+    for (size_t size : {100u, 10'000u, 1'000'000u, 10'000'000u})
+    {
+        std::vector<std::pair<std::string, int>> items;
+        items.reserve(size);
+        for (size_t i = 0; i < size; ++i)
+            items.emplace_back("key_" + std::to_string((i * 2654435761u) % 4294967291u), static_cast<int>(i));
+
+        std::vector<std::string> lookup_keys;
+        for (size_t i = 0; i < 1000; ++i)
+            lookup_keys.push_back(items[(i * 7919) % size].first);
+
+        const StringKeyMap<int> map(items.begin(), items.end());
+        const FlatStringKeyMap<int> flat_map(items.begin(), items.end());
+
+        const string suffix = " - " + to_string(size);
+
+        BENCHMARK("lookup - std::map" + suffix)
+        {
+            int total = 0;
+            for (const auto& key : lookup_keys)
+                total += map.find(key)->second;
+            return total;
+        };
+
+        BENCHMARK("lookup - FlatMap" + suffix)
+        {
+            int total = 0;
+            for (const auto& key : lookup_keys)
+                total += flat_map.find(key)->second;
+            return total;
+        };
+
+        if (size > 1'000'000)
+            continue; // iterating & building 10M maps 100 times takes minutes
+
+        BENCHMARK("iterate - std::map" + suffix)
+        {
+            long long total = 0;
+            for (const auto& [key, value] : map)
+                total += value;
+            return total;
+        };
+
+        BENCHMARK("iterate - FlatMap" + suffix)
+        {
+            long long total = 0;
+            for (const auto& [key, value] : flat_map)
+                total += value;
+            return total;
+        };
+
+        BENCHMARK("build - std::map" + suffix)
+        {
+            return StringKeyMap<int>(items.begin(), items.end()).size();
+        };
+
+        BENCHMARK("build - FlatMap" + suffix)
+        {
+            return FlatStringKeyMap<int>(items.begin(), items.end()).size();
+        };
+
+        if (size > 10'000)
+            continue; // single inserts into a flat map are O(n)
+
+        StringKeyMap<int> mutable_map = map;
+        FlatStringKeyMap<int> mutable_flat_map = flat_map;
+
+        BENCHMARK("insert & erase 100 keys - std::map" + suffix)
+        {
+            for (int i = 0; i < 100; ++i)
+                mutable_map.try_emplace("new_" + std::to_string(i), i);
+            for (int i = 0; i < 100; ++i)
+                mutable_map.erase("new_" + std::to_string(i));
+            return mutable_map.size();
+        };
+
+        BENCHMARK("insert & erase 100 keys - FlatMap" + suffix)
+        {
+            for (int i = 0; i < 100; ++i)
+                mutable_flat_map.try_emplace("new_" + std::to_string(i), i);
+            for (int i = 0; i < 100; ++i)
+                mutable_flat_map.erase("new_" + std::to_string(i));
+            return mutable_flat_map.size();
+        };
+    }
+}
+
+TEST_CASE("HashMap")
+{
+    SECTION("drop-in replacement of StringKeyMap")
+    {
+        HashStringKeyMap<int> hash_dict = {{"two", 2}, {"one", 1}, {"three", 3}};
+
+        REQUIRE(hash_dict.size() == 3);
+        REQUIRE(hash_dict.at("two") == 2);
+        REQUIRE(hash_dict["four"] == 0);
+        hash_dict["four"] = 4;
+
+        vector<string> keys;
+        for (const auto& [key, value] : hash_dict)
+            keys.push_back(key);
+        std::sort(keys.begin(), keys.end());
+        REQUIRE(keys == vector<string> {"four", "one", "three", "two"});
+    }
+
+    SECTION("heterogeneous lookup")
+    {
+        HashStringKeyMap<int> hash_dict = {{"one", 1}};
+        const string_view key = "one";
+
+        auto it = hash_dict.find(key);
+        REQUIRE(it != hash_dict.end());
+        REQUIRE(it->second == 1);
+        it->second = 11;
+        REQUIRE(hash_dict.at("one") == 11);
+
+        REQUIRE(hash_dict.find("zero"sv) == hash_dict.end());
+        REQUIRE_THROWS_AS(hash_dict.at("zero"), std::out_of_range);
+    }
+
+    SECTION("stable hash - equal for all string types & fixed across builds")
+    {
+        const StableHash hash;
+
+        REQUIRE(hash("configuration"s) == hash("configuration"sv));
+        REQUIRE(hash("configuration"s) == hash("configuration"));
+        REQUIRE(hash("") != hash("a"));
+        REQUIRE(hash("abcdefgh") != hash("abcdefgh\0"sv));
+        REQUIRE(hash("configuration") == 0x4de7d81b025c31c3ull); // pinned - a change breaks persisted hashes
+    }
+
+    SECTION("insert, assign & erase")
+    {
+        HashMap<string, int> hash_dict;
+        REQUIRE(hash_dict.try_emplace("b", 2).second);
+        REQUIRE(hash_dict.insert({"a", 1}).second);
+        REQUIRE_FALSE(hash_dict.insert({"a", 100}).second);
+        REQUIRE(hash_dict.insert_or_assign("c", 3).second);
+        REQUIRE_FALSE(hash_dict.insert_or_assign("a", 0).second);
+
+        REQUIRE(hash_dict.at("a") == 0);
+        REQUIRE(hash_dict.at("c") == 3);
+
+        REQUIRE(hash_dict.erase("b"sv) == 1);
+        REQUIRE(hash_dict.erase("b"sv) == 0);
+        REQUIRE(hash_dict.size() == 2);
+        REQUIRE_FALSE(hash_dict.contains("b"));
+    }
+
+    SECTION("same content as std::unordered_map after random inserts & erases")
+    {
+        struct WeakHash // 4 distinct hashes - long probe chains & tombstones
+        {
+            size_t operator()(int key) const noexcept
+            {
+                return static_cast<size_t>(key % 4);
+            }
+        };
+
+        HashMap<int, int, WeakHash> hash_map;
+        std::unordered_map<int, int> expected;
+        std::mt19937 rnd {665};
+
+        for (int i = 0; i < 20'000; ++i)
+        {
+            const int key = static_cast<int>(rnd() % 500);
+            if (rnd() % 3 == 0)
+                REQUIRE(hash_map.erase(key) == expected.erase(key));
+            else
+                REQUIRE(hash_map.try_emplace(key, i).second == expected.try_emplace(key, i).second);
+        }
+
+        REQUIRE(hash_map.size() == expected.size());
+        for (const auto& [key, value] : expected)
+            REQUIRE(hash_map.at(key) == value);
+
+        size_t visited = 0;
+        for (const auto& [key, value] : hash_map)
+        {
+            REQUIRE(expected.at(key) == value);
+            ++visited;
+        }
+        REQUIRE(visited == expected.size());
+    }
+
+    SECTION("copy & move")
+    {
+        HashStringKeyMap<string> original;
+        for (int i = 0; i < 100; ++i)
+            original[to_string(i)] = "value_" + to_string(i);
+
+        HashStringKeyMap<string> copy = original;
+        HashStringKeyMap<string> moved = std::move(original);
+
+        REQUIRE(copy.size() == 100);
+        REQUIRE(moved.size() == 100);
+        REQUIRE(original.empty());
+        REQUIRE(copy.at("42"sv) == "value_42");
+        REQUIRE(moved.at("99"sv) == "value_99");
+    }
+}
+
+TEST_CASE("HashMap vs. std::unordered_map & std::map", "[!benchmark]")
+{
+    for (size_t size : {100u, 10'000u, 1'000'000u})
+    {
+        std::vector<std::pair<std::string, int>> items;
+        items.reserve(size);
+        for (size_t i = 0; i < size; ++i)
+            items.emplace_back("key_" + std::to_string((i * 2654435761u) % 4294967291u), static_cast<int>(i));
+
+        std::vector<std::string> lookup_keys;
+        std::vector<std::string> missing_keys;
+        for (size_t i = 0; i < 1000; ++i)
+        {
+            lookup_keys.push_back(items[(i * 7919) % size].first);
+            missing_keys.push_back("missing_" + std::to_string(i));
+        }
+
+        const StringKeyMap<int> map(items.begin(), items.end());
+        const std::unordered_map<std::string, int> unordered_map(items.begin(), items.end());
+        const HashStringKeyMap<int> hash_map(items.begin(), items.end());
+
+        const string suffix = " - " + to_string(size);
+
+        BENCHMARK("lookup - std::map" + suffix)
+        {
+            int total = 0;
+            for (const auto& key : lookup_keys)
+                total += map.find(key)->second;
+            return total;
+        };
+
+        BENCHMARK("lookup - std::unordered_map" + suffix)
+        {
+            int total = 0;
+            for (const auto& key : lookup_keys)
+                total += unordered_map.find(key)->second;
+            return total;
+        };
+
+        BENCHMARK("lookup - HashMap" + suffix)
+        {
+            int total = 0;
+            for (const auto& key : lookup_keys)
+                total += hash_map.find(key)->second;
+            return total;
+        };
+
+        BENCHMARK("lookup missing - std::unordered_map" + suffix)
+        {
+            size_t found = 0;
+            for (const auto& key : missing_keys)
+                found += unordered_map.count(key);
+            return found;
+        };
+
+        BENCHMARK("lookup missing - HashMap" + suffix)
+        {
+            size_t found = 0;
+            for (const auto& key : missing_keys)
+                found += hash_map.count(key);
+            return found;
+        };
+
+        BENCHMARK("build - std::map" + suffix)
+        {
+            return StringKeyMap<int>(items.begin(), items.end()).size();
+        };
+
+        BENCHMARK("build - std::unordered_map" + suffix)
+        {
+            return std::unordered_map<std::string, int>(items.begin(), items.end()).size();
+        };
+
+        BENCHMARK("build - HashMap" + suffix)
+        {
+            return HashStringKeyMap<int>(items.begin(), items.end()).size();
+        };
+    }
+}
+
+TEST_CASE("DynamicBitset")
+{
+    SECTION("single bits")
+    {
+        DynamicBitset<> flags(100);
+        REQUIRE(flags.size() == 100);
+        REQUIRE(flags.none());
+
+        flags.set(3);
+        flags[64] = true;
+        flags.set(99).flip(98);
+        flags[3].flip();
+
+        REQUIRE_FALSE(flags[3]);
+        REQUIRE(flags.test(64));
+        REQUIRE(flags.test(98));
+        REQUIRE(flags.count() == 3);
+
+        flags.reset(64);
+        REQUIRE(flags.count() == 2);
+    }
+
+    SECTION("whole set operations keep bits after size() clear")
+    {
+        DynamicBitset<> flags(70, true);
+        REQUIRE(flags.all());
+        REQUIRE(flags.count() == 70);
+
+        flags.flip();
+        REQUIRE(flags.none());
+
+        flags.resize(130, true);
+        REQUIRE(flags.count() == 60);
+        REQUIRE(flags.find_first() == 70);
+
+        flags.set();
+        REQUIRE(flags.count() == 130);
+    }
+
+    SECTION("boolean operations & set bits - same as vector<bool>")
+    {
+        const size_t size = 10'000;
+        std::mt19937 rnd {665};
+        vector<bool> a(size), b(size);
+        DynamicBitset<> bits_a(size), bits_b(size);
+
+        for (size_t i = 0; i < size; ++i)
+        {
+            bits_a[i] = a[i] = rnd() % 3 == 0;
+            bits_b[i] = b[i] = rnd() % 50 == 0;
+        }
+
+        auto expected_indexes = [](const vector<bool>& flags) {
+            vector<size_t> result;
+            for (size_t i = 0; i < flags.size(); ++i)
+                if (flags[i])
+                    result.push_back(i);
+            return result;
+        };
+
+        auto indexes = [](const DynamicBitset<>& bits) {
+            vector<size_t> result;
+            for (size_t index : bits.set_bits())
+                result.push_back(index);
+            return result;
+        };
+
+        auto apply = [&](auto op) {
+            vector<bool> result(size);
+            for (size_t i = 0; i < size; ++i)
+                result[i] = op(a[i], b[i]);
+            return result;
+        };
+
+        REQUIRE(indexes(bits_a) == expected_indexes(a));
+        REQUIRE(indexes(bits_a & bits_b) == expected_indexes(apply([](bool x, bool y) { return x && y; })));
+        REQUIRE(indexes(bits_a | bits_b) == expected_indexes(apply([](bool x, bool y) { return x || y; })));
+        REQUIRE(indexes(bits_a ^ bits_b) == expected_indexes(apply([](bool x, bool y) { return x != y; })));
+        REQUIRE(indexes(bits_a - bits_b) == expected_indexes(apply([](bool x, bool y) { return x && !y; })));
+        REQUIRE(bits_b.count() == static_cast<size_t>(std::count(b.begin(), b.end(), true)));
+
+        vector<size_t> found;
+        for (size_t i = bits_b.find_first(); i != DynamicBitset<>::npos; i = bits_b.find_next(i))
+            found.push_back(i);
+        REQUIRE(found == expected_indexes(b));
+    }
+
+    SECTION("sparse bits - long runs of zero words")
+    {
+        DynamicBitset<> flags(1'000'000);
+        flags.set(5).set(700'000).set(999'999);
+
+        REQUIRE(flags.find_next(5) == 700'000);
+        REQUIRE(flags.find_next(700'000) == 999'999);
+        REQUIRE(flags.find_next(999'999) == DynamicBitset<>::npos);
+        REQUIRE(vector<size_t>(flags.set_bits().begin(), flags.set_bits().end()) == vector<size_t> {5, 700'000, 999'999});
+    }
+}
+
+TEST_CASE("DynamicBitset vs. vector<bool>", "[!benchmark]")
+{
+    const size_t size = 10'000'000;
+    std::mt19937 rnd {665};
+
+    vector<bool> flags_a(size), flags_b(size);
+    DynamicBitset<> bits_a(size), bits_b(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        bits_a[i] = flags_a[i] = rnd() % 2 == 0;
+        bits_b[i] = flags_b[i] = rnd() % 1000 == 0; // sparse
+    }
+
+    BENCHMARK("count - vector<bool>")
+    {
+        return std::count(flags_a.begin(), flags_a.end(), true);
+    };
+
+    BENCHMARK("count - DynamicBitset")
+    {
+        return bits_a.count();
+    };
+
+    BENCHMARK("and - vector<bool>")
+    {
+        vector<bool> result = flags_a;
+        for (size_t i = 0; i < size; ++i)
+            result[i] = result[i] && flags_b[i];
+        return result.size();
+    };
+
+    BENCHMARK("and - DynamicBitset")
+    {
+        DynamicBitset<> result = bits_a;
+        result &= bits_b;
+        return result.size();
+    };
+
+    BENCHMARK("xor in place - DynamicBitset")
+    {
+        bits_a ^= bits_b;
+        return bits_a.size();
+    };
+
+    BENCHMARK("visit sparse set bits - vector<bool>")
+    {
+        size_t total = 0;
+        for (size_t i = 0; i < size; ++i)
+            if (flags_b[i])
+                total += i;
+        return total;
+    };
+
+    BENCHMARK("visit sparse set bits - DynamicBitset")
+    {
+        size_t total = 0;
+        for (size_t i : bits_b.set_bits())
+            total += i;
+        return total;
+    };
+
+    BENCHMARK("find_next sparse - DynamicBitset")
+    {
+        size_t total = 0;
+        for (size_t i = bits_b.find_first(); i != DynamicBitset<>::npos; i = bits_b.find_next(i))
+            total += i;
+        return total;
+    };
+}
+
+TEST_CASE("select")
+{
+    tuple<int, double, string> tpl(1, 3.14, "text");
+
+    SECTION("any order & repeated indexes")
+    {
+        REQUIRE(select<2, 0>(tpl) == tuple<string, int>("text", 1));
+        REQUIRE(select<1, 1>(tpl) == tuple<double, double>(3.14, 3.14));
+    }
+
+    SECTION("rvalue tuple - selected elements are moved")
+    {
+        auto projection = select<2>(std::move(tpl));
+        REQUIRE(projection == tuple<string>("text"));
+
+        // move-only element - compiles only when moved
+        auto owner = select<0>(tuple<std::unique_ptr<int>, int>(std::make_unique<int>(42), 1));
+        REQUIRE(*get<0>(owner) == 42);
+    }
+
+    SECTION("select_ref - references to elements")
+    {
+        auto [id, text] = select_ref<0, 2>(tpl);
+        id = 2;
+        text = "changed";
+        REQUIRE(tpl == tuple<int, double, string>(2, 3.14, "changed"));
+    }
+
+    SECTION("select_ref of a const tuple - references to const elements")
+    {
+        const auto& const_tpl = tpl;
+        auto refs = select_ref<0, 2>(const_tpl);
+        static_assert(std::is_same_v<decltype(refs), tuple<const int&, const string&>>);
+        REQUIRE(&get<1>(refs) == &get<2>(tpl));
+    }
+
+    SECTION("pair & array")
+    {
+        static_assert(select<1>(std::pair {1, 'a'}) == tuple<char>('a'));
+        static_assert(select<3, 0>(std::array {1, 2, 3, 4}) == tuple<int, int>(4, 1));
+    }
+}
+
+TEST_CASE("SoaVector")
+{
+    SoaVector<int, double, string> records;
+    records.emplace_back(1, 1.5, "one");
+    records.push_back({2, 2.5, "two"});
+    records.emplace_back(3, 3.5, "three");
+
+    REQUIRE(records.size() == 3);
+    REQUIRE(records.column<0>() == vector<int> {1, 2, 3});
+    REQUIRE(records.row(1) == tuple<int, double, string>(2, 2.5, "two"));
+
+    SECTION("row of references")
+    {
+        get<2>(records[0]) = "uno";
+        REQUIRE(records.column<2>()[0] == "uno");
+    }
+
+    SECTION("select - a view of columns")
+    {
+        auto ids_and_names = select<0, 2>(records);
+        REQUIRE(ids_and_names.size() == 3);
+        REQUIRE(ids_and_names[2] == tuple<int&, string&>(records.column<0>()[2], records.column<2>()[2]));
+
+        for (auto [id, name] : ids_and_names)
+            name += to_string(id);
+        REQUIRE(records.column<2>() == vector<string> {"one1", "two2", "three3"});
+
+        const auto& const_records = records;
+        double total = 0.0;
+        for (auto [price] : select<1>(const_records))
+            total += price;
+        REQUIRE(total == 7.5);
+    }
+
+    SECTION("throwing column constructor leaves columns aligned")
+    {
+        struct Throwing
+        {
+            explicit Throwing(int value)
+            {
+                if (value < 0)
+                    throw std::invalid_argument("negative");
+            }
+        };
+
+        SoaVector<int, Throwing, string> rows;
+        rows.emplace_back(1, 1, "one");
+        REQUIRE_THROWS_AS(rows.emplace_back(2, -1, "two"), std::invalid_argument);
+
+        REQUIRE(rows.size() == 1);
+        REQUIRE(rows.column<0>().size() == 1);
+        REQUIRE(rows.column<1>().size() == 1);
+        REQUIRE(rows.column<2>().size() == 1);
+    }
+
+    SECTION("bool column - one byte per flag, flags are bool&")
+    {
+        SoaVector<int, bool> flags;
+        flags.emplace_back(1, true);
+        flags.emplace_back(2, false);
+
+        get<1>(flags[1]) = true;
+        REQUIRE(flags.row(1) == tuple<int, bool>(2, true));
+
+        int active = 0;
+        for (auto [id, flag] : select<0, 1>(flags))
+        {
+            active += flag ? id : 0;
+            flag = false;
+        }
+        REQUIRE(active == 3);
+
+        const auto& const_flags = flags;
+        REQUIRE(get<0>(select<1>(const_flags)[0]) == false);
+    }
+}
+
+namespace
+{
+    // 10 fields, a query touches 2 of them
+    using Record = tuple<int64_t, double, double, double, double, double, double, double, int32_t, int32_t>;
+}
+
+TEST_CASE("SoaVector vs. vector of tuples - 2 of 10 columns", "[!benchmark]")
+{
+    const size_t size = 1'000'000;
+
+    vector<Record> rows;
+    SoaVector<int64_t, double, double, double, double, double, double, double, int32_t, int32_t> columns;
+    rows.reserve(size);
+    columns.reserve(size);
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        Record record {static_cast<int64_t>(i), i * 0.5, 0, 0, 0, 0, 0, 0, static_cast<int32_t>(i % 100), 0};
+        rows.push_back(record);
+        columns.push_back(record);
+    }
+
+    BENCHMARK("price * quantity - vector<tuple>")
+    {
+        double total = 0.0;
+        for (const auto& row : rows)
+        {
+            auto [price, quantity] = select<1, 8>(row);
+            total += price * quantity;
+        }
+        return total;
+    };
+
+    BENCHMARK("price * quantity - SoaVector")
+    {
+        double total = 0.0;
+        for (auto [price, quantity] : select<1, 8>(columns))
+            total += price * quantity;
+        return total;
+    };
+}
@@ -0,0 +1,324 @@
+#ifndef CHECKED_ARITHMETIC_HPP
+#define CHECKED_ARITHMETIC_HPP
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+namespace Checked
+{
+    enum class Direction
+    {
+        below,
+        above
+    };
+
+    /////////////////////////////////////////////////////////////////
+    // OverflowPolicy - what to do with a result that does not fit
+    //
+    struct Throwing
+    {
+        template <typename T>
+        static constexpr T overflow(T /*wrapped*/, Direction /*direction*/)
+        {
+            throw std::overflow_error("arithmetic overflow");
+        }
+
+        template <typename T>
+        static constexpr T out_of_range(T /*value*/, T /*low*/, T /*high*/)
+        {
+            throw std::out_of_range("range error");
+        }
+    };
+
+    /////////////////////////////////////////////////////////////////
+    // OverflowPolicy
+    //
+    struct Saturating
+    {
+        template <typename T>
+        static constexpr T overflow(T /*wrapped*/, Direction direction) noexcept
+        {
+            return direction == Direction::above ? std::numeric_limits<T>::max() : std::numeric_limits<T>::min();
+        }
+
+        template <typename T>
+        static constexpr T out_of_range(T value, T low, T high) noexcept
+        {
+            return value < low ? low : high;
+        }
+    };
+
+    /////////////////////////////////////////////////////////////////
+    // OverflowPolicy
+    //
+    struct Wrapping
+    {
+        template <typename T>
+        static constexpr T overflow(T wrapped, Direction /*direction*/) noexcept
+        {
+            return wrapped;
+        }
+
+        template <typename T>
+        static constexpr T out_of_range(T value, T low, T high) noexcept
+        {
+            using U = unsigned long long;
+
+            const U range = static_cast<U>(high) - static_cast<U>(low) + 1;
+            if (range == 0) // full range of 64-bit type
+                return value;
+
+            return value < low
+                ? static_cast<T>(static_cast<U>(high) - (static_cast<U>(low) - static_cast<U>(value) - 1) % range)
+                : static_cast<T>(static_cast<U>(low) + (static_cast<U>(value) - static_cast<U>(low)) % range);
+        }
+    };
+
+    /////////////////////////////////////////////////////////////////
+    // checked operations on built-in integers
+    //
+    template <typename TTarget, typename TSource>
+    constexpr bool in_range(TSource value) noexcept
+    {
+        if constexpr (!std::is_integral_v<TTarget> || !std::is_integral_v<TSource>)
+            return true;
+        else if constexpr (std::is_signed_v<TSource> == std::is_signed_v<TTarget>)
+            return std::numeric_limits<TTarget>::min() <= value && value <= std::numeric_limits<TTarget>::max();
+        else if constexpr (std::is_signed_v<TSource>)
+            return value >= 0 && static_cast<std::make_unsigned_t<TSource>>(value) <= std::numeric_limits<TTarget>::max();
+        else
+            return value <= static_cast<std::make_unsigned_t<TTarget>>(std::numeric_limits<TTarget>::max());
+    }
+
+    template <typename TTarget, typename Policy = Throwing, typename TSource>
+    constexpr TTarget narrow(TSource value)
+    {
+        if (in_range<TTarget>(value))
+            return static_cast<TTarget>(value);
+
+        return Policy::overflow(static_cast<TTarget>(value), value < TSource {} ? Direction::below : Direction::above);
+    }
+
+    template <typename T>
+    constexpr T wrapping_add(T a, T b) noexcept
+    {
+        using U = std::make_unsigned_t<T>;
+        return static_cast<T>(static_cast<U>(a) + static_cast<U>(b));
+    }
+
+    template <typename T>
+    constexpr T wrapping_sub(T a, T b) noexcept
+    {
+        using U = std::make_unsigned_t<T>;
+        return static_cast<T>(static_cast<U>(a) - static_cast<U>(b));
+    }
+
+    template <typename T>
+    constexpr T wrapping_mul(T a, T b) noexcept
+    {
+        using U = std::make_unsigned_t<std::common_type_t<T, unsigned>>; // no promotion of small types to int
+        return static_cast<T>(static_cast<U>(a) * static_cast<U>(b));
+    }
+
+    template <typename Policy = Throwing, typename T>
+    constexpr T add(T a, T b)
+    {
+        static_assert(std::is_integral_v<T>, "integral types only");
+
+        constexpr T min = std::numeric_limits<T>::min();
+        constexpr T max = std::numeric_limits<T>::max();
+
+        if (b > 0 && a > max - b)
+            return Policy::overflow(wrapping_add(a, b), Direction::above);
+        if constexpr (std::is_signed_v<T>)
+            if (b < 0 && a < min - b)
+                return Policy::overflow(wrapping_add(a, b), Direction::below);
+
+        return static_cast<T>(a + b);
+    }
+
+    template <typename Policy = Throwing, typename T>
+    constexpr T sub(T a, T b)
+    {
+        static_assert(std::is_integral_v<T>, "integral types only");
+
+        constexpr T min = std::numeric_limits<T>::min();
+        constexpr T max = std::numeric_limits<T>::max();
+
+        if constexpr (std::is_signed_v<T>)
+        {
+            if (b < 0 && a > max + b)
+                return Policy::overflow(wrapping_sub(a, b), Direction::above);
+            if (b > 0 && a < min + b)
+                return Policy::overflow(wrapping_sub(a, b), Direction::below);
+        }
+        else if (a < b)
+            return Policy::overflow(wrapping_sub(a, b), Direction::below);
+
+        return static_cast<T>(a - b);
+    }
+
+    template <typename Policy = Throwing, typename T>
+    constexpr T mul(T a, T b)
+    {
+        static_assert(std::is_integral_v<T>, "integral types only");
+
+        constexpr T min = std::numeric_limits<T>::min();
+        constexpr T max = std::numeric_limits<T>::max();
+
+        if (a == 0 || b == 0)
+            return 0;
+
+        const bool negative = std::is_signed_v<T> && ((a < 0) != (b < 0));
+        const Direction direction = negative ? Direction::below : Direction::above;
+
+        if constexpr (std::is_signed_v<T>)
+        {
+            const bool overflows = (a > 0)
+                ? (b > 0 ? a > max / b : b < min / a)
+                : (b > 0 ? a < min / b : (a == min || b == min || -a > max / -b));
+
+            if (overflows)
+                return Policy::overflow(wrapping_mul(a, b), direction);
+        }
+        else if (a > max / b)
+            return Policy::overflow(wrapping_mul(a, b), direction);
+
+        return static_cast<T>(a * b);
+    }
+
+    template <typename Policy = Throwing, typename T>
+    constexpr T div(T a, T b)
+    {
+        static_assert(std::is_integral_v<T>, "integral types only");
+
+        if (b == 0)
+            throw std::domain_error("division by zero");
+
+        if constexpr (std::is_signed_v<T>)
+            if (a == std::numeric_limits<T>::min() && b == -1)
+                return Policy::overflow(a, Direction::above);
+
+        return static_cast<T>(a / b);
+    }
+
+    // the remainder always fits - only min % -1 is special, as the hardware may trap on it
+    template <typename T>
+    constexpr T mod(T a, T b)
+    {
+        static_assert(std::is_integral_v<T>, "integral types only");
+
+        if (b == 0)
+            throw std::domain_error("division by zero");
+
+        if constexpr (std::is_signed_v<T>)
+            if (b == -1)
+                return 0;
+
+        return static_cast<T>(a % b);
+    }
+
+    /////////////////////////////////////////////////////////////////
+    // Bounded<T, Low, High> - integer always in [Low, High]
+    //
+    // A range is checked only when a value comes from outside. Results of
+    // arithmetic on bounded values get bounds computed at compile time,
+    // so they need no runtime checks at all.
+    //
+    struct Unchecked
+    {
+    };
+
+    inline constexpr Unchecked unchecked {};
+
+    template <typename T, T Low, T High>
+    class Bounded
+    {
+        static_assert(std::is_integral_v<T>, "integral types only");
+        static_assert(Low <= High, "empty range");
+
+        T value_;
+
+    public:
+        using value_type = T;
+        static constexpr T low = Low;
+        static constexpr T high = High;
+
+        template <typename Policy = Throwing>
+        static constexpr Bounded make(T value) noexcept(noexcept(Policy::out_of_range(value, Low, High)))
+        {
+            return Bounded {(Low <= value && value <= High) ? value : Policy::out_of_range(value, Low, High), unchecked};
+        }
+
+        // caller guarantees that a value is in range
+        constexpr Bounded(T value, Unchecked) noexcept
+            : value_ {value}
+        {
+        }
+
+        constexpr Bounded() noexcept
+            : value_ {Low}
+        {
+        }
+
+        // throws std::out_of_range - a compile error in constant expressions
+        constexpr explicit Bounded(T value)
+            : value_ {make<Throwing>(value).value()}
+        {
+        }
+
+        // no check if [L, H] is a subrange of [Low, High]
+        template <T L, T H, typename = std::enable_if_t<(Low <= L && H <= High)>>
+        constexpr Bounded(Bounded<T, L, H> other) noexcept
+            : value_ {other.value()}
+        {
+        }
+
+        constexpr T value() const noexcept
+        {
+            return value_;
+        }
+
+        constexpr operator T() const noexcept
+        {
+            return value_;
+        }
+
+        template <T L, T H>
+        friend constexpr auto operator+(Bounded a, Bounded<T, L, H> b) noexcept
+        {
+            using Result = Bounded<T, add(Low, L), add(High, H)>;
+            return Result {static_cast<T>(a.value() + b.value()), unchecked};
+        }
+
+        template <T L, T H>
+        friend constexpr auto operator-(Bounded a, Bounded<T, L, H> b) noexcept
+        {
+            using Result = Bounded<T, sub(Low, H), sub(High, L)>;
+            return Result {static_cast<T>(a.value() - b.value()), unchecked};
+        }
+
+        template <T L, T H>
+        friend constexpr auto operator*(Bounded a, Bounded<T, L, H> b) noexcept
+        {
+            constexpr T p1 = mul(Low, L), p2 = mul(Low, H), p3 = mul(High, L), p4 = mul(High, H);
+
+            using Result = Bounded<T, std::min({p1, p2, p3, p4}), std::max({p1, p2, p3, p4})>;
+            return Result {static_cast<T>(a.value() * b.value()), unchecked};
+        }
+    };
+
+    // conversion to another range - checked by Policy only when ranges are not nested
+    template <typename TBounded, typename Policy = Throwing, typename T, T Low, T High>
+    constexpr TBounded bounded_cast(Bounded<T, Low, High> value)
+    {
+        if constexpr (TBounded::low <= Low && High <= TBounded::high)
+            return value;
+        else
+            return TBounded::template make<Policy>(value.value());
+    }
+}
+
+#endif // CHECKED_ARITHMETIC_HPP
@@ -0,0 +1,255 @@
+#ifndef COMBINATORICS_HPP
+#define COMBINATORICS_HPP
+
+#include "lookup_tables.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Numerics
+{
+    /////////////////////////////////////////////////////////////////
+    // BigUnsigned - arbitrary precision unsigned integer
+    //
+    // Only operations needed for exact combinatorics: multiplication and
+    // exact division by a machine word.
+    //
+    class BigUnsigned
+    {
+        std::vector<uint32_t> limbs_; // little-endian, no leading zero limbs - zero is empty
+
+    public:
+        BigUnsigned(uint64_t value = 0)
+        {
+            for (; value != 0; value >>= 32)
+                limbs_.push_back(static_cast<uint32_t>(value));
+        }
+
+        BigUnsigned& operator*=(uint32_t factor)
+        {
+            if (factor == 0)
+            {
+                limbs_.clear();
+                return *this;
+            }
+
+            uint64_t carry = 0;
+            for (uint32_t& limb : limbs_)
+            {
+                const uint64_t product = static_cast<uint64_t>(limb) * factor + carry;
+                limb = static_cast<uint32_t>(product);
+                carry = product >> 32;
+            }
+
+            if (carry != 0)
+                limbs_.push_back(static_cast<uint32_t>(carry));
+
+            return *this;
+        }
+
+        // returns a remainder
+        uint32_t divide(uint32_t divisor)
+        {
+            if (divisor == 0)
+                throw std::domain_error("division by zero");
+
+            uint64_t remainder = 0;
+            for (auto it = limbs_.rbegin(); it != limbs_.rend(); ++it)
+            {
+                const uint64_t current = (remainder << 32) | *it;
+                *it = static_cast<uint32_t>(current / divisor);
+                remainder = current % divisor;
+            }
+
+            while (!limbs_.empty() && limbs_.back() == 0)
+                limbs_.pop_back();
+
+            return static_cast<uint32_t>(remainder);
+        }
+
+        bool fits_uint64() const noexcept
+        {
+            return limbs_.size() <= 2;
+        }
+
+        uint64_t to_uint64() const
+        {
+            if (!fits_uint64())
+                throw std::overflow_error("value does not fit in uint64_t");
+
+            uint64_t result = 0;
+            for (auto it = limbs_.rbegin(); it != limbs_.rend(); ++it)
+                result = (result << 32) | *it;
+
+            return result;
+        }
+
+        std::string to_string() const
+        {
+            if (limbs_.empty())
+                return "0";
+
+            BigUnsigned value = *this;
+            std::vector<uint32_t> chunks; // base 10^9 digits
+            while (!value.limbs_.empty())
+                chunks.push_back(value.divide(1'000'000'000));
+
+            std::string result = std::to_string(chunks.back());
+            for (auto it = std::next(chunks.rbegin()); it != chunks.rend(); ++it)
+            {
+                const std::string chunk = std::to_string(*it);
+                result.append(9 - chunk.size(), '0').append(chunk);
+            }
+
+            return result;
+        }
+
+        friend bool operator==(const BigUnsigned& a, const BigUnsigned& b) noexcept
+        {
+            return a.limbs_ == b.limbs_;
+        }
+
+        friend bool operator!=(const BigUnsigned& a, const BigUnsigned& b) noexcept
+        {
+            return !(a == b);
+        }
+
+        friend std::ostream& operator<<(std::ostream& out, const BigUnsigned& value)
+        {
+            return out << value.to_string();
+        }
+    };
+
+    /////////////////////////////////////////////////////////////////
+    // CombinatoricsCache - memoized exact n!, C(n, k) and P(n, k)
+    //
+    // Factorials 0!..20! come from a compile-time table, bigger ones are
+    // appended on demand. Readers share a lock, only extending the cache
+    // takes an exclusive one. Returned references stay valid for
+    // the lifetime of the cache (deque & map never move their elements).
+    //
+    class CombinatoricsCache
+    {
+        static constexpr size_t compile_time_prefix = 21;
+        static constexpr auto factorial_prefix = Lut::make_factorial_table<compile_time_prefix>();
+
+        mutable std::shared_mutex mtx_;
+        std::deque<BigUnsigned> factorials_;
+        std::map<std::pair<uint32_t, uint32_t>, BigUnsigned> binomials_;
+        std::map<std::pair<uint32_t, uint32_t>, BigUnsigned> permutations_;
+
+    public:
+        CombinatoricsCache()
+            : factorials_(factorial_prefix.begin(), factorial_prefix.end())
+        {
+        }
+
+        CombinatoricsCache(const CombinatoricsCache&) = delete;
+        CombinatoricsCache& operator=(const CombinatoricsCache&) = delete;
+
+        const BigUnsigned& factorial(uint32_t n)
+        {
+            {
+                std::shared_lock lk {mtx_};
+                if (n < factorials_.size())
+                    return factorials_[n];
+            }
+
+            std::unique_lock lk {mtx_};
+            while (factorials_.size() <= n)
+            {
+                BigUnsigned next = factorials_.back();
+                next *= static_cast<uint32_t>(factorials_.size());
+                factorials_.push_back(std::move(next));
+            }
+
+            return factorials_[n];
+        }
+
+        // C(n, k) - number of k-element subsets of n-element set
+        const BigUnsigned& binomial(uint32_t n, uint32_t k)
+        {
+            if (k > n)
+                return zero();
+
+            k = std::min(k, n - k);
+
+            return memoized(binomials_, {n, k}, [n, k] {
+                BigUnsigned result = 1;
+                for (uint32_t i = 1; i <= k; ++i)
+                {
+                    result *= n - k + i;
+                    result.divide(i); // exact - product of i consecutive numbers is divisible by i!
+                }
+                return result;
+            });
+        }
+
+        // P(n, k) - number of k-element sequences without repetition from n-element set
+        const BigUnsigned& permutations(uint32_t n, uint32_t k)
+        {
+            if (k > n)
+                return zero();
+
+            return memoized(permutations_, {n, k}, [n, k] {
+                BigUnsigned result = 1;
+                for (uint32_t i = n - k + 1; i <= n; ++i)
+                    result *= i;
+                return result;
+            });
+        }
+
+    private:
+        static const BigUnsigned& zero()
+        {
+            static const BigUnsigned value {0};
+            return value;
+        }
+
+        template <typename F>
+        const BigUnsigned& memoized(std::map<std::pair<uint32_t, uint32_t>, BigUnsigned>& cache, std::pair<uint32_t, uint32_t> key, F compute)
+        {
+            {
+                std::shared_lock lk {mtx_};
+                if (auto it = cache.find(key); it != cache.end())
+                    return it->second;
+            }
+
+            BigUnsigned value = compute(); // outside of the lock - other threads may compute it too
+
+            std::unique_lock lk {mtx_};
+            return cache.try_emplace(key, std::move(value)).first->second;
+        }
+    };
+
+    inline CombinatoricsCache& combinatorics()
+    {
+        static CombinatoricsCache cache;
+        return cache;
+    }
+
+    inline const BigUnsigned& big_factorial(uint32_t n)
+    {
+        return combinatorics().factorial(n);
+    }
+
+    inline const BigUnsigned& binomial(uint32_t n, uint32_t k)
+    {
+        return combinatorics().binomial(n, k);
+    }
+
+    inline const BigUnsigned& permutations(uint32_t n, uint32_t k)
+    {
+        return combinatorics().permutations(n, k);
+    }
+}
+
+#endif // COMBINATORICS_HPP
@@ -0,0 +1,311 @@
+#ifndef CONFIG_PARSER_HPP
+#define CONFIG_PARSER_HPP
+
+#include "checked_arithmetic.hpp"
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+/////////////////////////////////////////////////////////////////
+// constexpr parser of configuration strings
+//
+// Malformed input throws std::invalid_argument - used in a constant
+// expression it is a compile error pointing at the failed rule.
+//
+// Grammar:
+//   config  := entry ((';' | ',' | '\n') entry)*
+//   entry   := <empty> | key '=' value
+//   value   := expr | 'true' | 'false' | '"' chars '"'
+//   expr    := term (('+' | '-') term)*
+//   term    := factor (('*' | '/' | '%') factor)*
+//   factor  := number | '(' expr ')' | '-' factor
+//   number  := decimal | '0x' hexadecimal
+//
+namespace ConfigParser
+{
+    class Parser
+    {
+        std::string_view text_;
+        size_t pos_ = 0;
+
+    public:
+        constexpr explicit Parser(std::string_view text) noexcept
+            : text_ {text}
+        {
+        }
+
+        constexpr bool at_end()
+        {
+            skip_spaces();
+            return pos_ == text_.size();
+        }
+
+        constexpr char peek()
+        {
+            skip_spaces();
+            return pos_ < text_.size() ? text_[pos_] : '\0';
+        }
+
+        constexpr bool accept(char c)
+        {
+            if (peek() != c)
+                return false;
+
+            ++pos_;
+            return true;
+        }
+
+        constexpr void expect(char c)
+        {
+            if (!accept(c))
+                throw std::invalid_argument("config: unexpected character");
+        }
+
+        constexpr bool accept(std::string_view word)
+        {
+            skip_spaces();
+
+            if (text_.substr(pos_, word.size()) != word)
+                return false;
+
+            const size_t end = pos_ + word.size();
+            if (end < text_.size() && is_identifier_char(text_[end]))
+                return false;
+
+            pos_ = end;
+            return true;
+        }
+
+        constexpr std::string_view identifier()
+        {
+            skip_spaces();
+
+            const size_t start = pos_;
+            while (pos_ < text_.size() && is_identifier_char(text_[pos_]))
+                ++pos_;
+
+            if (start == pos_ || is_digit(text_[start]))
+                throw std::invalid_argument("config: identifier expected");
+
+            return text_.substr(start, pos_ - start);
+        }
+
+        constexpr std::string_view quoted_string()
+        {
+            expect('"');
+
+            const size_t start = pos_;
+            while (pos_ < text_.size() && text_[pos_] != '"' && text_[pos_] != '\n')
+                ++pos_;
+
+            if (pos_ == text_.size() || text_[pos_] != '"')
+                throw std::invalid_argument("config: unterminated string");
+
+            return text_.substr(start, pos_++ - start);
+        }
+
+        constexpr long long expr()
+        {
+            long long result = term();
+
+            while (true)
+            {
+                if (accept('+'))
+                    result = Checked::add(result, term());
+                else if (accept('-'))
+                    result = Checked::sub(result, term());
+                else
+                    return result;
+            }
+        }
+
+        constexpr bool separator()
+        {
+            skip_spaces();
+
+            if (pos_ < text_.size() && (text_[pos_] == ';' || text_[pos_] == ',' || text_[pos_] == '\n'))
+            {
+                ++pos_;
+                return true;
+            }
+
+            return false;
+        }
+
+    private:
+        static constexpr bool is_digit(char c) noexcept
+        {
+            return '0' <= c && c <= '9';
+        }
+
+        static constexpr bool is_identifier_char(char c) noexcept
+        {
+            return is_digit(c) || ('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z') || c == '_' || c == '.';
+        }
+
+        static constexpr int hex_digit(char c) noexcept
+        {
+            if (is_digit(c))
+                return c - '0';
+            if ('a' <= c && c <= 'f')
+                return c - 'a' + 10;
+            if ('A' <= c && c <= 'F')
+                return c - 'A' + 10;
+            return -1;
+        }
+
+        // spaces & tabs - a new line separates entries
+        constexpr void skip_spaces() noexcept
+        {
+            while (pos_ < text_.size() && (text_[pos_] == ' ' || text_[pos_] == '\t' || text_[pos_] == '\r'))
+                ++pos_;
+        }
+
+        constexpr long long term()
+        {
+            long long result = factor();
+
+            while (true)
+            {
+                if (accept('*'))
+                    result = Checked::mul(result, factor());
+                else if (accept('/'))
+                    result = Checked::div(result, factor());
+                else if (accept('%'))
+                    result = Checked::mod(result, factor());
+                else
+                    return result;
+            }
+        }
+
+        constexpr long long factor()
+        {
+            if (accept('('))
+            {
+                const long long result = expr();
+                expect(')');
+                return result;
+            }
+
+            if (accept('-'))
+                return Checked::sub(0LL, factor());
+
+            return number();
+        }
+
+        constexpr long long number()
+        {
+            skip_spaces();
+
+            const bool hex = text_.substr(pos_, 2) == "0x" || text_.substr(pos_, 2) == "0X";
+            const long long base = hex ? 16 : 10;
+            if (hex)
+                pos_ += 2;
+
+            const size_t start = pos_;
+            long long result = 0;
+
+            for (; pos_ < text_.size(); ++pos_)
+            {
+                const int digit = hex ? hex_digit(text_[pos_]) : (is_digit(text_[pos_]) ? text_[pos_] - '0' : -1);
+                if (digit < 0)
+                    break;
+
+                result = Checked::add(Checked::mul(result, base), static_cast<long long>(digit));
+            }
+
+            if (start == pos_)
+                throw std::invalid_argument("config: number expected");
+
+            return result;
+        }
+    };
+
+    template <typename TConfig, typename T>
+    struct Field
+    {
+        std::string_view key;
+        T TConfig::*member;
+    };
+
+    template <typename TConfig, typename T>
+    constexpr Field<TConfig, T> field(std::string_view key, T TConfig::*member) noexcept
+    {
+        return Field<TConfig, T> {key, member};
+    }
+
+    template <typename T>
+    constexpr T parse_value(Parser& parser)
+    {
+        if constexpr (std::is_same_v<T, bool>)
+        {
+            if (parser.accept(std::string_view {"true"}))
+                return true;
+            if (parser.accept(std::string_view {"false"}))
+                return false;
+
+            throw std::invalid_argument("config: true or false expected");
+        }
+        else if constexpr (std::is_integral_v<T>)
+        {
+            return Checked::narrow<T>(parser.expr());
+        }
+        else if constexpr (std::is_same_v<T, std::string_view>)
+        {
+            return parser.quoted_string();
+        }
+        else
+        {
+            static_assert(std::is_integral_v<T>, "unsupported type of configuration field");
+        }
+    }
+
+    template <typename TConfig, typename T>
+    constexpr bool try_set(TConfig& config, std::string_view key, Parser& parser, const Field<TConfig, T>& field)
+    {
+        if (field.key != key)
+            return false;
+
+        config.*field.member = parse_value<T>(parser);
+        return true;
+    }
+
+    // evaluates a constant numeric expression
+    constexpr long long eval(std::string_view expression)
+    {
+        Parser parser {expression};
+        const long long result = parser.expr();
+
+        if (!parser.at_end())
+            throw std::invalid_argument("config: unexpected character");
+
+        return result;
+    }
+
+    // parses 'key = value' entries into TConfig - fields not mentioned keep their default values
+    template <typename TConfig, typename... TFields>
+    constexpr TConfig parse_config(std::string_view text, TFields... fields)
+    {
+        TConfig config {};
+        Parser parser {text};
+
+        while (!parser.at_end())
+        {
+            if (parser.separator())
+                continue;
+
+            const std::string_view key = parser.identifier();
+            parser.expect('=');
+
+            if (!(try_set(config, key, parser, fields) || ...))
+                throw std::invalid_argument("config: unknown key");
+
+            if (!parser.at_end() && !parser.separator())
+                throw std::invalid_argument("config: separator expected");
+        }
+
+        return config;
+    }
+}
+
+#endif // CONFIG_PARSER_HPP
@@ -0,0 +1,190 @@
+#ifndef LOOKUP_TABLES_HPP
+#define LOOKUP_TABLES_HPP
+
+#include "checked_arithmetic.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+/////////////////////////////////////////////////////////////////
+// make_lut<N>(f) - table of f(0), f(1), ..., f(N-1)
+//
+// make_lut<N, T>(f) stores values as T and fails to compile (when used in
+// a constant expression) if any value does not fit in T - a throw in
+// a constant expression is a compile error.
+//
+template <size_t N, typename T = void, typename F>
+constexpr auto make_lut(F f)
+{
+    using TResult = decltype(f(size_t {}));
+    using TValue = std::conditional_t<std::is_void_v<T>, TResult, T>;
+
+    std::array<TValue, N> lut {};
+
+    for (size_t i = 0; i < N; ++i)
+        lut[i] = Checked::narrow<TValue>(f(i));
+
+    return lut;
+}
+
+namespace Lut
+{
+    /////////////////////////////////////////////////////////////////
+    // factorials & powers
+    //
+    constexpr uint64_t factorial(size_t n)
+    {
+        uint64_t result = 1;
+
+        for (size_t i = 2; i <= n; ++i)
+            result = Checked::mul<Checked::Throwing, uint64_t>(result, i);
+
+        return result;
+    }
+
+    constexpr uint64_t power(uint64_t base, size_t exponent)
+    {
+        uint64_t result = 1;
+
+        for (size_t i = 0; i < exponent; ++i)
+            result = Checked::mul(result, base);
+
+        return result;
+    }
+
+    template <size_t N>
+    constexpr std::array<uint64_t, N> make_factorial_table()
+    {
+        return make_lut<N>(factorial);
+    }
+
+    template <uint64_t Base, size_t N>
+    constexpr std::array<uint64_t, N> make_power_table()
+    {
+        return make_lut<N>([](size_t exponent) { return power(Base, exponent); });
+    }
+
+    /////////////////////////////////////////////////////////////////
+    // popcount
+    //
+    constexpr unsigned popcount_bitwise(uint64_t value)
+    {
+        unsigned count = 0;
+
+        for (; value != 0; value >>= 1)
+            count += value & 1;
+
+        return count;
+    }
+
+    inline constexpr auto popcount_table = make_lut<256, uint8_t>(popcount_bitwise);
+
+    constexpr unsigned popcount(uint64_t value)
+    {
+        unsigned count = 0;
+
+        for (size_t i = 0; i < sizeof(value); ++i, value >>= 8)
+            count += popcount_table[value & 0xFF];
+
+        return count;
+    }
+
+    /////////////////////////////////////////////////////////////////
+    // CRC32 (IEEE 802.3, reflected polynomial 0xEDB88320)
+    //
+    constexpr uint32_t crc32_polynomial = 0xEDB88320;
+
+    constexpr uint32_t crc32_byte_bitwise(uint32_t crc)
+    {
+        for (int bit = 0; bit < 8; ++bit)
+            crc = (crc & 1) ? (crc >> 1) ^ crc32_polynomial : crc >> 1;
+
+        return crc;
+    }
+
+    inline constexpr auto crc32_table = make_lut<256, uint32_t>(crc32_byte_bitwise);
+
+    constexpr uint32_t crc32_bitwise(std::string_view data)
+    {
+        uint32_t crc = 0xFFFFFFFF;
+
+        for (unsigned char c : data)
+            crc = crc32_byte_bitwise(crc ^ c);
+
+        return ~crc;
+    }
+
+    constexpr uint32_t crc32(std::string_view data)
+    {
+        uint32_t crc = 0xFFFFFFFF;
+
+        for (unsigned char c : data)
+            crc = crc32_table[(crc ^ c) & 0xFF] ^ (crc >> 8);
+
+        return ~crc;
+    }
+
+    /////////////////////////////////////////////////////////////////
+    // sin/cos in Q15 fixed point - N samples of a full period
+    //
+    constexpr double pi = 3.14159265358979323846;
+
+    // Taylor series - std::sin is not constexpr
+    constexpr double sin_taylor(double x)
+    {
+        while (x > pi)
+            x -= 2 * pi;
+        while (x < -pi)
+            x += 2 * pi;
+
+        double term = x;
+        double result = x;
+
+        for (int i = 1; i < 20; ++i)
+        {
+            term *= -x * x / ((2 * i) * (2 * i + 1));
+            result += term;
+        }
+
+        return result;
+    }
+
+    constexpr long round_to_long(double value)
+    {
+        return static_cast<long>(value < 0 ? value - 0.5 : value + 0.5);
+    }
+
+    template <size_t N>
+    constexpr std::array<int16_t, N> make_sin_q15_table()
+    {
+        static_assert(N % 4 == 0, "N must be a multiple of 4 - cos is sin shifted by N/4");
+
+        return make_lut<N, int16_t>([](size_t i) {
+            return round_to_long(32767 * sin_taylor(2 * pi * static_cast<double>(i) / N));
+        });
+    }
+
+    template <size_t N>
+    class SinCosQ15
+    {
+        static constexpr std::array<int16_t, N> table_ = make_sin_q15_table<N>();
+
+    public:
+        static constexpr size_t size = N;
+
+        // phase in 1/N of a full period
+        static constexpr int16_t sin(size_t phase)
+        {
+            return table_[phase % N];
+        }
+
+        static constexpr int16_t cos(size_t phase)
+        {
+            return table_[(phase + N / 4) % N];
+        }
+    };
+}
+
+#endif // LOOKUP_TABLES_HPP
@@ -1,7 +1,16 @@
 #include "catch.hpp"
+#include "checked_arithmetic.hpp"
+#include "combinatorics.hpp"
+#include "config_parser.hpp"
+#include "lookup_tables.hpp"
 #include <array>
+#include <bitset>
+#include <cmath>
 #include <iostream>
+#include <numeric>
+#include <random>
 #include <string>
+#include <thread>
 #include <vector>
 
 using namespace std;
@@ -43,12 +52,7 @@ TEST_CASE("factorial")
 template <size_t N>
 constexpr std::array<uint64_t, N> create_factorial_lookup()
 {
-    std::array<uint64_t, N> result {};
-
-    for (size_t i = 0; i < N; ++i)
-        result[i] = factorial(i);
-
-    return result;
+    return make_lut<N>(Lut::factorial);
 }
 
 TEST_CASE("factorial lookup")
@@ -61,6 +65,202 @@ TEST_CASE("factorial lookup")
     auto constexpr_lambda = [](int a) { return factorial(2 * a); };
 
     static_assert(constexpr_lambda(2) == 24);
+
+    constexpr auto max_lookup = create_factorial_lookup<21>();
+    static_assert(max_lookup[20] == 2'432'902'008'176'640'000ULL);
+
+    // constexpr auto overflow_lookup = create_factorial_lookup<22>(); // error: 21! overflows uint64_t
+}
+
+TEST_CASE("big factorial & combinatorics")
+{
+    using namespace Numerics;
+
+    SECTION("factorials from compile-time prefix")
+    {
+        REQUIRE(big_factorial(0) == 1);
+        REQUIRE(big_factorial(20).to_uint64() == 2'432'902'008'176'640'000ULL);
+    }
+
+    SECTION("factorials beyond uint64_t")
+    {
+        REQUIRE(big_factorial(21).to_string() == "51090942171709440000");
+        REQUIRE(big_factorial(30).to_string() == "265252859812191058636308480000000");
+        REQUIRE(big_factorial(100).to_string().size() == 158);
+        REQUIRE_FALSE(big_factorial(21).fits_uint64());
+    }
+
+    SECTION("repeated queries return cached values")
+    {
+        REQUIRE(&big_factorial(50) == &big_factorial(50));
+        REQUIRE(&binomial(60, 30) == &binomial(60, 30));
+    }
+
+    SECTION("binomial coefficients")
+    {
+        REQUIRE(binomial(5, 2) == 10);
+        REQUIRE(binomial(5, 3) == 10);
+        REQUIRE(binomial(5, 0) == 1);
+        REQUIRE(binomial(5, 6) == 0);
+        REQUIRE(binomial(100, 50).to_string() == "100891344545564193334812497256");
+    }
+
+    SECTION("permutations")
+    {
+        REQUIRE(permutations(10, 3) == 720);
+        REQUIRE(permutations(10, 0) == 1);
+        REQUIRE(permutations(3, 4) == 0);
+        REQUIRE(permutations(25, 25) == big_factorial(25));
+    }
+
+    SECTION("cache is extended concurrently")
+    {
+        CombinatoricsCache cache;
+
+        std::vector<std::string> results(8);
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < results.size(); ++i)
+            threads.emplace_back([&cache, &result = results[i], i] {
+                for (uint32_t n = 0; n < 300; ++n)
+                    cache.factorial(n + static_cast<uint32_t>(i));
+                result = cache.factorial(300).to_string();
+            });
+        for (auto& thd : threads)
+            thd.join();
+
+        for (const auto& result : results)
+            REQUIRE(result == big_factorial(300).to_string());
+    }
+}
+
+TEST_CASE("make_lut")
+{
+    SECTION("values are checked against the type of table")
+    {
+        constexpr auto squares = make_lut<16, uint8_t>([](size_t i) { return i * i; });
+        static_assert(squares[15] == 225);
+
+        // constexpr auto overflow = make_lut<17, uint8_t>([](size_t i) { return i * i; }); // error: 256 does not fit in uint8_t
+
+        auto squares_to_16 = [] { return make_lut<17, uint8_t>([](size_t i) { return i * i; }); };
+        REQUIRE_THROWS_AS(squares_to_16(), std::overflow_error);
+    }
+
+    SECTION("power table")
+    {
+        constexpr auto powers_of_10 = Lut::make_power_table<10, 20>();
+        static_assert(powers_of_10[19] == 10'000'000'000'000'000'000ULL);
+
+        // constexpr auto overflow = Lut::make_power_table<10, 21>(); // error: 10^20 overflows uint64_t
+    }
+
+    SECTION("popcount")
+    {
+        static_assert(Lut::popcount_table[0xFF] == 8);
+        static_assert(Lut::popcount(0xF0F0'0000'0000'0001ULL) == 9);
+
+        std::mt19937_64 rnd {665};
+        for (int i = 0; i < 1000; ++i)
+        {
+            const uint64_t value = rnd();
+            REQUIRE(Lut::popcount(value) == std::bitset<64>(value).count());
+        }
+    }
+
+    SECTION("crc32")
+    {
+        static_assert(Lut::crc32_table[1] == 0x77073096);
+        static_assert(Lut::crc32("123456789") == 0xCBF43926);
+        static_assert(Lut::crc32("123456789") == Lut::crc32_bitwise("123456789"));
+    }
+
+    SECTION("sin & cos in Q15")
+    {
+        using SinCos = Lut::SinCosQ15<1024>;
+
+        static_assert(SinCos::sin(0) == 0);
+        static_assert(SinCos::sin(256) == 32767);
+        static_assert(SinCos::cos(0) == 32767);
+        static_assert(SinCos::cos(512) == -32767);
+
+        for (size_t phase = 0; phase < SinCos::size; ++phase)
+        {
+            const double angle = 2 * Lut::pi * phase / SinCos::size;
+            REQUIRE(std::abs(SinCos::sin(phase) - 32767 * std::sin(angle)) <= 1.0);
+            REQUIRE(std::abs(SinCos::cos(phase) - 32767 * std::cos(angle)) <= 1.0);
+        }
+    }
+}
+
+TEST_CASE("lookup tables vs. computation", "[!benchmark]")
+{
+    std::mt19937_64 rnd {665};
+
+    std::vector<uint64_t> values(4096);
+    for (auto& value : values)
+        value = rnd();
+
+    std::string data(64 * 1024, '\0');
+    for (auto& c : data)
+        c = static_cast<char>(rnd());
+
+    std::vector<uint8_t> exponents(4096);
+    for (auto& exponent : exponents)
+        exponent = rnd() % 20;
+
+    BENCHMARK("popcount - bitwise")
+    {
+        return std::accumulate(values.begin(), values.end(), 0u, [](unsigned total, uint64_t v) { return total + Lut::popcount_bitwise(v); });
+    };
+
+    BENCHMARK("popcount - lookup")
+    {
+        return std::accumulate(values.begin(), values.end(), 0u, [](unsigned total, uint64_t v) { return total + Lut::popcount(v); });
+    };
+
+    BENCHMARK("crc32 64KB - bitwise")
+    {
+        return Lut::crc32_bitwise(data);
+    };
+
+    BENCHMARK("crc32 64KB - lookup")
+    {
+        return Lut::crc32(data);
+    };
+
+    BENCHMARK("sin Q15 - std::sin")
+    {
+        int64_t total = 0;
+        for (size_t phase = 0; phase < values.size(); ++phase)
+            total += std::lround(32767 * std::sin(2 * Lut::pi * (values[phase] % 1024) / 1024));
+        return total;
+    };
+
+    BENCHMARK("sin Q15 - lookup")
+    {
+        int64_t total = 0;
+        for (size_t phase = 0; phase < values.size(); ++phase)
+            total += Lut::SinCosQ15<1024>::sin(values[phase] % 1024);
+        return total;
+    };
+
+    BENCHMARK("10^n - multiplication")
+    {
+        uint64_t total = 0;
+        for (uint8_t exponent : exponents)
+            total += Lut::power(10, exponent);
+        return total;
+    };
+
+    BENCHMARK("10^n - lookup")
+    {
+        static constexpr auto powers_of_10 = Lut::make_power_table<10, 20>();
+
+        uint64_t total = 0;
+        for (uint8_t exponent : exponents)
+            total += powers_of_10[exponent];
+        return total;
+    };
 }
 
 constexpr int check(int i)
@@ -77,4 +277,242 @@ TEST_CASE("constexpr + throw")
 {
     constexpr int value = check(59);
     static_assert(value == 59);
+}
+
+TEST_CASE("checked arithmetic")
+{
+    using namespace Checked;
+
+    constexpr int max = std::numeric_limits<int>::max();
+    constexpr int min = std::numeric_limits<int>::min();
+
+    SECTION("throwing")
+    {
+        static_assert(add(2, 3) == 5);
+        static_assert(mul(-4, 5) == -20);
+        // constexpr int overflow = add(max, 1); // error: overflow in constant expression
+
+        REQUIRE_THROWS_AS(add(max, 1), std::overflow_error);
+        REQUIRE_THROWS_AS(sub(min, 1), std::overflow_error);
+        REQUIRE_THROWS_AS(mul(min, -1), std::overflow_error);
+        REQUIRE_THROWS_AS(Checked::div(min, -1), std::overflow_error);
+        REQUIRE_THROWS_AS(Checked::div(1, 0), std::domain_error);
+        REQUIRE(Checked::mod(min, -1) == 0);
+        REQUIRE_THROWS_AS(Checked::mod(1, 0), std::domain_error);
+        REQUIRE_THROWS_AS(sub(0u, 1u), std::overflow_error);
+    }
+
+    SECTION("saturating")
+    {
+        static_assert(add<Saturating>(max, 1) == max);
+        static_assert(sub<Saturating>(min, 1) == min);
+        static_assert(mul<Saturating>(max / 2, -3) == min);
+        static_assert(mul<Saturating>(min, min) == max);
+        static_assert(sub<Saturating, uint8_t>(1, 2) == 0);
+        static_assert(narrow<uint8_t, Saturating>(300) == 255);
+        static_assert(narrow<uint8_t, Saturating>(-1) == 0);
+    }
+
+    SECTION("wrapping")
+    {
+        static_assert(add<Wrapping>(max, 1) == min);
+        static_assert(mul<Wrapping, uint8_t>(16, 17) == 16);
+        static_assert(narrow<int8_t, Wrapping>(200) == -56);
+    }
+}
+
+TEST_CASE("Bounded")
+{
+    using namespace Checked;
+
+    using Percent = Bounded<int, 0, 100>;
+    using Digit = Bounded<int, 0, 9>;
+
+    SECTION("values are checked when constructed")
+    {
+        constexpr Percent p {59};
+        static_assert(p == 59);
+        // constexpr Percent error {101}; // error: out of range in constant expression
+
+        REQUIRE_THROWS_AS(Percent {101}, std::out_of_range);
+        REQUIRE(Percent::make<Saturating>(101) == 100);
+        REQUIRE(Percent::make<Saturating>(-5) == 0);
+        REQUIRE(Digit::make<Wrapping>(12) == 2);
+        REQUIRE(Digit::make<Wrapping>(-1) == 9);
+    }
+
+    SECTION("arithmetic widens bounds at compile time - no runtime checks")
+    {
+        constexpr Digit d1 {7};
+        constexpr Digit d2 {8};
+
+        constexpr auto sum = d1 + d2;
+        static_assert(std::is_same_v<decltype(sum), const Bounded<int, 0, 18>>);
+        static_assert(sum == 15);
+
+        constexpr auto diff = d1 - d2;
+        static_assert(std::is_same_v<decltype(diff), const Bounded<int, -9, 9>>);
+
+        constexpr auto number = d1 * Bounded<int, 10, 10> {10} + d2;
+        static_assert(std::is_same_v<decltype(number), const Bounded<int, 0, 99>>);
+        static_assert(number == 78);
+
+        static_assert(noexcept(d1 + d2 * d1));
+        // Bounded<int, 0, std::numeric_limits<int>::max()>{} + Digit{}; // error: upper bound overflows int
+    }
+
+    SECTION("conversions between ranges")
+    {
+        Digit d {5};
+
+        Percent p = d; // no check - [0, 9] is inside [0, 100]
+        REQUIRE(p == 5);
+
+        REQUIRE(bounded_cast<Digit>(Percent {9}) == 9);
+        REQUIRE_THROWS_AS(bounded_cast<Digit>(Percent {10}), std::out_of_range);
+        REQUIRE(bounded_cast<Digit, Saturating>(Percent {50}) == 9);
+    }
+}
+
+struct ServerConfig
+{
+    int threads = 1;
+    uint16_t port = 80;
+    size_t buffer_size = 4096;
+    bool verbose = false;
+    std::string_view name = "server";
+};
+
+constexpr ServerConfig parse_server_config(std::string_view text)
+{
+    using namespace ConfigParser;
+
+    return parse_config<ServerConfig>(text,
+        field("threads", &ServerConfig::threads),
+        field("port", &ServerConfig::port),
+        field("buffer_size", &ServerConfig::buffer_size),
+        field("verbose", &ServerConfig::verbose),
+        field("name", &ServerConfig::name));
+}
+
+TEST_CASE("constexpr config parser")
+{
+    SECTION("numeric expressions")
+    {
+        static_assert(ConfigParser::eval("2 + 3 * 4") == 14);
+        static_assert(ConfigParser::eval("(2 + 3) * 4") == 20);
+        static_assert(ConfigParser::eval("-(7 - 10) % 2") == 1);
+        static_assert(ConfigParser::eval("0x10 * 1024") == 16384);
+        // constexpr auto error = ConfigParser::eval("2 +* 3"); // error: number expected
+
+        REQUIRE_THROWS_AS(ConfigParser::eval("2 +* 3"), std::invalid_argument);
+        REQUIRE_THROWS_AS(ConfigParser::eval("(1 + 2"), std::invalid_argument);
+        REQUIRE_THROWS_AS(ConfigParser::eval("1 / (2 - 2)"), std::domain_error);
+        REQUIRE_THROWS_AS(ConfigParser::eval("1 % (2 - 2)"), std::domain_error);
+        REQUIRE(ConfigParser::eval("(-9223372036854775807 - 1) % -1") == 0);
+        REQUIRE_THROWS_AS(ConfigParser::eval("9223372036854775807 + 1"), std::overflow_error);
+    }
+
+    SECTION("key=value list into a struct")
+    {
+        constexpr ServerConfig config = parse_server_config(R"(
+            threads = 2 * 4; port = 8000 + 80
+            buffer_size = 64 * 1024, name = "edge-01"
+            verbose = true
+        )");
+
+        static_assert(config.threads == 8);
+        static_assert(config.port == 8080);
+        static_assert(config.buffer_size == 65536);
+        static_assert(config.verbose);
+        static_assert(config.name == "edge-01");
+    }
+
+    SECTION("missing keys keep default values")
+    {
+        constexpr ServerConfig config = parse_server_config("port = 443");
+
+        static_assert(config.port == 443);
+        static_assert(config.threads == 1);
+        static_assert(config.name == "server");
+    }
+
+    SECTION("malformed input")
+    {
+        // constexpr ServerConfig error = parse_server_config("port = 70000"); // error: value out of range
+
+        REQUIRE_THROWS_AS(parse_server_config("port = 70000"), std::overflow_error);
+        REQUIRE_THROWS_AS(parse_server_config("timeout = 5"), std::invalid_argument);
+        REQUIRE_THROWS_AS(parse_server_config("threads 5"), std::invalid_argument);
+        REQUIRE_THROWS_AS(parse_server_config("threads = 5 port = 80"), std::invalid_argument);
+        REQUIRE_THROWS_AS(parse_server_config("verbose = 1"), std::invalid_argument);
+        REQUIRE_THROWS_AS(parse_server_config("name = \"edge"), std::invalid_argument);
+    }
+}
+
+TEST_CASE("memoized vs. computed combinatorics", "[!benchmark]")
+{
+    using namespace Numerics;
+
+    big_factorial(1000);
+    binomial(1000, 500);
+
+    BENCHMARK("1000! - computed")
+    {
+        BigUnsigned result = 1;
+        for (uint32_t i = 2; i <= 1000; ++i)
+            result *= i;
+        return result;
+    };
+
+    BENCHMARK("1000! - cached")
+    {
+        return &big_factorial(1000);
+    };
+
+    BENCHMARK("C(1000, 500) - cached")
+    {
+        return &binomial(1000, 500);
+    };
+}
+
+TEST_CASE("Bounded vs. checked arithmetic in a loop", "[!benchmark]")
+{
+    using namespace Checked;
+
+    using Channel = Bounded<int, 0, 255>;
+
+    std::vector<Channel> pixels(64 * 1024);
+    std::mt19937 rnd {665};
+    for (auto& pixel : pixels)
+        pixel = Channel {static_cast<int>(rnd() % 256)};
+
+    const std::vector<int> raw_pixels(pixels.begin(), pixels.end());
+
+    // weighted blend of neighbours - (a * 3 + b) fits easily in int
+    BENCHMARK("raw int")
+    {
+        int total = 0;
+        for (size_t i = 1; i < raw_pixels.size(); ++i)
+            total += (raw_pixels[i - 1] * 3 + raw_pixels[i]) >> 2;
+        return total;
+    };
+
+    BENCHMARK("Checked::add & Checked::mul")
+    {
+        int total = 0;
+        for (size_t i = 1; i < raw_pixels.size(); ++i)
+            total = add(total, add(mul(raw_pixels[i - 1], 3), raw_pixels[i]) >> 2);
+        return total;
+    };
+
+    BENCHMARK("Bounded")
+    {
+        constexpr Bounded<int, 3, 3> three {3};
+
+        int total = 0;
+        for (size_t i = 1; i < pixels.size(); ++i)
+            total += (pixels[i - 1] * three + pixels[i]).value() >> 2;
+        return total;
+    };
 }
\ No newline at end of file
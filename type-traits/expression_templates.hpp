@@ -0,0 +1,220 @@
+#ifndef EXPRESSION_TEMPLATES_HPP
+#define EXPRESSION_TEMPLATES_HPP
+
+#include "sum_traits.hpp"
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/////////////////////////////////////////////////////////////////
+// element-wise container arithmetic with expression templates
+//
+// a * b + c builds a lightweight expression object - nothing is computed
+// until the expression is reduced (sum) or materialized (evaluate), which
+// happens in a single loop without temporary containers.
+//
+// Operators are found only after `using namespace ElementWise;`
+//
+namespace ElementWise
+{
+    struct ExpressionBase
+    {
+    };
+
+    template <typename T>
+    constexpr bool is_expression_v = std::is_base_of_v<ExpressionBase, T>;
+
+    template <typename T, typename = void>
+    struct IsContainer : std::false_type
+    {
+    };
+
+    template <typename T>
+    struct IsContainer<T, std::void_t<typename T::value_type, decltype(std::declval<const T&>().size()), decltype(std::declval<const T&>()[0])>>
+        : std::true_type
+    {
+    };
+
+    template <typename T, typename = void>
+    struct IsNumericContainer : std::false_type
+    {
+    };
+
+    template <typename T>
+    struct IsNumericContainer<T, std::enable_if_t<IsContainer<T>::value>> : std::is_arithmetic<typename T::value_type>
+    {
+    };
+
+    template <typename T>
+    constexpr bool is_container_v = IsNumericContainer<T>::value && !is_expression_v<T>;
+
+    template <typename TContainer>
+    class Terminal : public ExpressionBase
+    {
+        const TContainer& container_;
+
+    public:
+        using value_type = typename TContainer::value_type;
+
+        explicit Terminal(const TContainer& container) noexcept
+            : container_ {container}
+        {
+        }
+
+        size_t size() const noexcept
+        {
+            return container_.size();
+        }
+
+        template <typename TResult>
+        TResult eval(size_t index) const
+        {
+            return static_cast<TResult>(container_[index]);
+        }
+    };
+
+    template <typename T>
+    class Scalar : public ExpressionBase
+    {
+        T value_;
+
+    public:
+        using value_type = T;
+        static constexpr size_t any_size = 0;
+
+        explicit Scalar(T value) noexcept
+            : value_ {value}
+        {
+        }
+
+        size_t size() const noexcept
+        {
+            return any_size;
+        }
+
+        template <typename TResult>
+        TResult eval(size_t) const
+        {
+            return static_cast<TResult>(value_);
+        }
+    };
+
+    template <typename TOperation, typename TLeft, typename TRight>
+    class BinaryExpression : public ExpressionBase
+    {
+        TLeft left_;
+        TRight right_;
+
+    public:
+        // type of the operation on element types - with integral promotion, as for plain C++ operands (uint8_t * uint8_t is int)
+        using value_type = decltype(TOperation {}(std::declval<typename TLeft::value_type>(), std::declval<typename TRight::value_type>()));
+
+        BinaryExpression(TLeft left, TRight right) noexcept
+            : left_ {left}
+            , right_ {right}
+        {
+            assert(left_.size() == right_.size() || left_.size() == 0 || right_.size() == 0);
+        }
+
+        size_t size() const noexcept
+        {
+            return left_.size() != 0 ? left_.size() : right_.size();
+        }
+
+        // all arithmetic is done in TResult - e.g. widened accumulator of SumTraits
+        template <typename TResult>
+        TResult eval(size_t index) const
+        {
+            return TOperation {}(left_.template eval<TResult>(index), right_.template eval<TResult>(index));
+        }
+
+        value_type operator[](size_t index) const
+        {
+            return eval<value_type>(index);
+        }
+    };
+
+    // lifts an operand into an expression - expressions are stored by value, containers by reference
+    template <typename T>
+    auto as_expression(const T& operand)
+    {
+        if constexpr (is_expression_v<T>)
+            return operand;
+        else if constexpr (std::is_arithmetic_v<T>)
+            return Scalar<T>(operand);
+        else
+            return Terminal<T>(operand);
+    }
+
+    template <typename T>
+    constexpr bool is_range_operand_v = is_expression_v<T> || is_container_v<T>;
+
+    // at least one operand is a range, the other may be a scalar
+    template <typename TLeft, typename TRight>
+    constexpr bool are_operands_v = (is_range_operand_v<TLeft> && (is_range_operand_v<TRight> || std::is_arithmetic_v<TRight>))
+        || (std::is_arithmetic_v<TLeft> && is_range_operand_v<TRight>);
+
+    template <typename TOperation, typename TLeft, typename TRight>
+    auto make_expression(const TLeft& left, const TRight& right)
+    {
+        using L = decltype(as_expression(left));
+        using R = decltype(as_expression(right));
+
+        return BinaryExpression<TOperation, L, R>(as_expression(left), as_expression(right));
+    }
+
+    template <typename TLeft, typename TRight, typename = std::enable_if_t<are_operands_v<TLeft, TRight>>>
+    auto operator+(const TLeft& left, const TRight& right)
+    {
+        return make_expression<std::plus<>>(left, right);
+    }
+
+    template <typename TLeft, typename TRight, typename = std::enable_if_t<are_operands_v<TLeft, TRight>>>
+    auto operator-(const TLeft& left, const TRight& right)
+    {
+        return make_expression<std::minus<>>(left, right);
+    }
+
+    template <typename TLeft, typename TRight, typename = std::enable_if_t<are_operands_v<TLeft, TRight>>>
+    auto operator*(const TLeft& left, const TRight& right)
+    {
+        return make_expression<std::multiplies<>>(left, right);
+    }
+
+    template <typename TLeft, typename TRight, typename = std::enable_if_t<are_operands_v<TLeft, TRight>>>
+    auto operator/(const TLeft& left, const TRight& right)
+    {
+        return make_expression<std::divides<>>(left, right);
+    }
+
+    // reduction in one pass - accumulator type & zero come from SumTraits
+    template <typename TExpression, typename = std::enable_if_t<is_expression_v<TExpression>>>
+    auto sum(const TExpression& expression)
+    {
+        using T = typename TExpression::value_type;
+        using TResult = typename SumTraits<T>::SumType;
+
+        TResult result = SumTraits<T>::zero;
+        const size_t size = expression.size();
+        for (size_t i = 0; i < size; ++i)
+            SumPolicy<TResult, TResult>::sum(result, expression.template eval<TResult>(i));
+
+        return result;
+    }
+
+    template <typename TExpression, typename = std::enable_if_t<is_expression_v<TExpression>>>
+    auto evaluate(const TExpression& expression)
+    {
+        std::vector<typename TExpression::value_type> result(expression.size());
+
+        for (size_t i = 0; i < result.size(); ++i)
+            result[i] = expression[i];
+
+        return result;
+    }
+}
+
+#endif // EXPRESSION_TEMPLATES_HPP
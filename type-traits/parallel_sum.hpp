@@ -0,0 +1,209 @@
+#ifndef PARALLEL_SUM_HPP
+#define PARALLEL_SUM_HPP
+
+#include "sum_traits.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace Parallel
+{
+    /////////////////////////////////////////////////////////////////
+    // ThreadPool - fixed number of workers sharing one task queue
+    //
+    class ThreadPool
+    {
+        inline static thread_local const ThreadPool* current_pool_ = nullptr; // pool of a worker running on this thread
+
+        std::vector<std::thread> workers_;
+        std::queue<std::function<void()>> tasks_;
+        std::mutex mtx_;
+        std::condition_variable cv_;
+        bool done_ = false;
+
+    public:
+        explicit ThreadPool(size_t size = std::max(1u, std::thread::hardware_concurrency()))
+        {
+            workers_.reserve(size);
+            for (size_t i = 0; i < size; ++i)
+                workers_.emplace_back([this] { run(); });
+        }
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        ~ThreadPool()
+        {
+            {
+                std::lock_guard lk {mtx_};
+                done_ = true;
+            }
+            cv_.notify_all();
+
+            for (auto& worker : workers_)
+                worker.join();
+        }
+
+        size_t size() const noexcept
+        {
+            return workers_.size();
+        }
+
+        // true when called from a task of this pool - waiting there for other tasks of the pool may deadlock
+        bool is_worker_thread() const noexcept
+        {
+            return current_pool_ == this;
+        }
+
+        template <typename F>
+        auto submit(F task) -> std::future<std::invoke_result_t<F>>
+        {
+            auto packaged_task = std::make_shared<std::packaged_task<std::invoke_result_t<F>()>>(std::move(task));
+            auto result = packaged_task->get_future();
+
+            {
+                std::lock_guard lk {mtx_};
+                tasks_.push([packaged_task] { (*packaged_task)(); });
+            }
+            cv_.notify_one();
+
+            return result;
+        }
+
+    private:
+        void run()
+        {
+            current_pool_ = this;
+
+            while (true)
+            {
+                std::function<void()> task;
+
+                {
+                    std::unique_lock lk {mtx_};
+                    cv_.wait(lk, [this] { return done_ || !tasks_.empty(); });
+
+                    if (tasks_.empty())
+                        return;
+
+                    task = std::move(tasks_.front());
+                    tasks_.pop();
+                }
+
+                task();
+            }
+        }
+    };
+
+    inline ThreadPool& default_pool()
+    {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    // ~L2-sized chunks - fixed for an element type, never derived from a number of threads
+    template <typename T>
+    constexpr size_t default_chunk_size = std::max<size_t>(1, (256 * 1024) / sizeof(T));
+
+    template <typename TIterator>
+    struct Range
+    {
+        TIterator first, last;
+
+        TIterator begin() const
+        {
+            return first;
+        }
+
+        TIterator end() const
+        {
+            return last;
+        }
+    };
+
+    /////////////////////////////////////////////////////////////////
+    // sum - Traits::sum of chunks on a thread pool
+    //
+    // Chunk boundaries depend only on the size of a container and chunk_size,
+    // partial results are combined with TSumPolicy in chunk order - a result
+    // (also a rounded floating point one) is the same for any number of threads.
+    // Called from a task of the same pool (nested sums) chunks are summed
+    // inline - blocked workers would never run queued chunks.
+    //
+    template <template <typename, typename> class TSumPolicy = SumPolicy, typename TContainer>
+    auto sum(const TContainer& container, ThreadPool& pool, size_t chunk_size = 0)
+    {
+        using TIterator = decltype(std::begin(container));
+        using T = std::remove_cv_t<std::remove_reference_t<decltype(*std::begin(container))>>;
+        using TResult = typename SumTraits<T>::SumType;
+
+        if constexpr (!std::is_base_of_v<std::random_access_iterator_tag, typename std::iterator_traits<TIterator>::iterator_category>)
+        {
+            return Traits::sum<TSumPolicy>(container);
+        }
+        else
+        {
+            if (chunk_size == 0)
+                chunk_size = default_chunk_size<T>;
+
+            const auto first = std::begin(container);
+            const size_t size = static_cast<size_t>(std::distance(first, std::end(container)));
+            const size_t chunk_count = (size + chunk_size - 1) / chunk_size;
+
+            if (chunk_count <= 1)
+                return Traits::sum<TSumPolicy>(container);
+
+            std::vector<TResult> partial_sums(chunk_count, SumTraits<T>::zero);
+            std::atomic<size_t> next_chunk {0};
+
+            auto sum_chunks = [&] {
+                for (size_t chunk = next_chunk++; chunk < chunk_count; chunk = next_chunk++)
+                {
+                    const size_t chunk_begin = chunk * chunk_size;
+                    const size_t chunk_end = std::min(size, chunk_begin + chunk_size);
+                    partial_sums[chunk] = Traits::sum<TSumPolicy>(Range<TIterator> {first + chunk_begin, first + chunk_end});
+                }
+            };
+
+            if (pool.is_worker_thread())
+                sum_chunks();
+            else
+            {
+                std::vector<std::future<void>> workers;
+                const size_t worker_count = std::min(pool.size(), chunk_count);
+                workers.reserve(worker_count);
+                for (size_t i = 0; i < worker_count; ++i)
+                    workers.push_back(pool.submit(sum_chunks));
+
+                for (auto& worker : workers) // all workers finish before locals go out of scope
+                    worker.wait();
+                for (auto& worker : workers)
+                    worker.get();
+            }
+
+            TResult result = SumTraits<T>::zero;
+            for (const auto& partial_sum : partial_sums)
+                TSumPolicy<TResult, TResult>::sum(result, partial_sum);
+
+            return result;
+        }
+    }
+
+    template <template <typename, typename> class TSumPolicy = SumPolicy, typename TContainer>
+    auto sum(const TContainer& container)
+    {
+        return sum<TSumPolicy>(container, default_pool());
+    }
+}
+
+#endif // PARALLEL_SUM_HPP
@@ -0,0 +1,468 @@
+#ifndef SIMD_SUM_HPP
+#define SIMD_SUM_HPP
+
+#include "sum_traits.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define SIMD_SUM_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(SIMD_SUM_X86) && (defined(__GNUC__) || defined(__clang__))
+#define SIMD_SUM_AVX2 1
+#define SIMD_SUM_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+/////////////////////////////////////////////////////////////////
+// vectorized kernels for Traits::sum
+//
+// SSE2 is a baseline of x86-64. AVX2 kernels are compiled with a function
+// target attribute and selected at runtime, so the binary still runs on
+// CPUs without AVX2. Other platforms use portable loops.
+//
+// Float kernels rely on strict IEEE semantics - do not build with -ffast-math.
+//
+namespace Simd
+{
+    struct CpuFeatures
+    {
+        bool avx2 = false;
+    };
+
+    inline const CpuFeatures& cpu_features()
+    {
+        static const CpuFeatures features = [] {
+            CpuFeatures result;
+#ifdef SIMD_SUM_AVX2
+            __builtin_cpu_init();
+            result.avx2 = __builtin_cpu_supports("avx2");
+#endif
+            return result;
+        }();
+
+        return features;
+    }
+
+    namespace Kernels
+    {
+        /////////////////////////////////////////////////////////////////
+        // portable kernels
+        //
+
+        // partial sums in TPartial for blocks small enough not to overflow - the inner loop vectorizes
+        template <typename TWide, typename TPartial, size_t BlockSize, typename T>
+        TWide sum_in_blocks(const T* data, size_t size)
+        {
+            TWide total = 0;
+
+            for (size_t start = 0; start < size; start += BlockSize)
+            {
+                const size_t end = std::min(size, start + BlockSize);
+
+                TPartial partial = 0;
+                for (size_t i = start; i < end; ++i)
+                    partial += data[i];
+
+                total += partial;
+            }
+
+            return total;
+        }
+
+        // independent accumulators break the dependency chain of a single sum;
+        // floats are accumulated in double - SumTraits<float>::SumType
+        inline double sum_float_portable(const float* data, size_t size)
+        {
+            double acc[8] = {};
+
+            size_t i = 0;
+            for (; i + 8 <= size; i += 8)
+                for (size_t lane = 0; lane < 8; ++lane)
+                    acc[lane] += data[i + lane];
+
+            double total = ((acc[0] + acc[1]) + (acc[2] + acc[3])) + ((acc[4] + acc[5]) + (acc[6] + acc[7]));
+            for (; i < size; ++i)
+                total += data[i];
+
+            return total;
+        }
+
+        inline float kahan_sum_portable(const float* data, size_t size)
+        {
+            float sum = 0.0f;
+            float compensation = 0.0f;
+
+            for (size_t i = 0; i < size; ++i)
+            {
+                const float y = data[i] - compensation;
+                const float t = sum + y;
+                compensation = (t - sum) - y;
+                sum = t;
+            }
+
+            return sum;
+        }
+
+#ifdef SIMD_SUM_X86
+        /////////////////////////////////////////////////////////////////
+        // SSE2 kernels
+        //
+        inline uint64_t sum_u8_sse2(const uint8_t* data, size_t size)
+        {
+            const __m128i zero = _mm_setzero_si128();
+            __m128i acc = zero;
+
+            size_t i = 0;
+            for (; i + 16 <= size; i += 16)
+            {
+                const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+                acc = _mm_add_epi64(acc, _mm_sad_epu8(bytes, zero)); // two sums of 8 bytes
+            }
+
+            alignas(16) uint64_t lanes[2];
+            _mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc);
+
+            uint64_t total = lanes[0] + lanes[1];
+            for (; i < size; ++i)
+                total += data[i];
+
+            return total;
+        }
+
+        // madd with ones sums pairs of shorts into 32-bit lanes; unsigned shorts are biased to signed range
+        template <typename T>
+        auto sum_i16_sse2(const T* data, size_t size)
+        {
+            static_assert(std::is_same_v<T, int16_t> || std::is_same_v<T, uint16_t>);
+            constexpr bool is_unsigned = std::is_unsigned_v<T>;
+            constexpr size_t block_size = 8 * 16384; // 16384 pair sums (|sum| <= 2^16) fit in int32 lane
+
+            const __m128i ones = _mm_set1_epi16(1);
+            const __m128i bias = _mm_set1_epi16(is_unsigned ? static_cast<int16_t>(0x8000) : 0);
+
+            int64_t total = 0;
+            size_t i = 0;
+            const size_t vectorized_size = size - size % 8;
+
+            while (i < vectorized_size)
+            {
+                const size_t block_end = std::min(vectorized_size, i + block_size);
+
+                __m128i acc = _mm_setzero_si128();
+                for (; i < block_end; i += 8)
+                {
+                    const __m128i shorts = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)), bias);
+                    acc = _mm_add_epi32(acc, _mm_madd_epi16(shorts, ones));
+                }
+
+                alignas(16) int32_t lanes[4];
+                _mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc);
+                total += (static_cast<int64_t>(lanes[0]) + lanes[1]) + (static_cast<int64_t>(lanes[2]) + lanes[3]);
+            }
+
+            using TResult = std::conditional_t<is_unsigned, uint64_t, int64_t>;
+            TResult result = static_cast<TResult>(total);
+            if constexpr (is_unsigned)
+                result += 0x8000ull * vectorized_size;
+
+            for (; i < size; ++i)
+                result += data[i];
+
+            return result;
+        }
+
+        inline double sum_float_sse2(const float* data, size_t size)
+        {
+            __m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd(), acc2 = _mm_setzero_pd(), acc3 = _mm_setzero_pd();
+
+            size_t i = 0;
+            for (; i + 8 <= size; i += 8)
+            {
+                const __m128 low = _mm_loadu_ps(data + i);
+                const __m128 high = _mm_loadu_ps(data + i + 4);
+                acc0 = _mm_add_pd(acc0, _mm_cvtps_pd(low));
+                acc1 = _mm_add_pd(acc1, _mm_cvtps_pd(_mm_movehl_ps(low, low)));
+                acc2 = _mm_add_pd(acc2, _mm_cvtps_pd(high));
+                acc3 = _mm_add_pd(acc3, _mm_cvtps_pd(_mm_movehl_ps(high, high)));
+            }
+
+            alignas(16) double lanes[2];
+            _mm_store_pd(lanes, _mm_add_pd(_mm_add_pd(acc0, acc1), _mm_add_pd(acc2, acc3)));
+
+            double total = lanes[0] + lanes[1];
+            for (; i < size; ++i)
+                total += data[i];
+
+            return total;
+        }
+
+        inline float kahan_sum_sse2(const float* data, size_t size)
+        {
+            __m128 sum = _mm_setzero_ps();
+            __m128 compensation = _mm_setzero_ps();
+
+            size_t i = 0;
+            for (; i + 4 <= size; i += 4)
+            {
+                const __m128 y = _mm_sub_ps(_mm_loadu_ps(data + i), compensation);
+                const __m128 t = _mm_add_ps(sum, y);
+                compensation = _mm_sub_ps(_mm_sub_ps(t, sum), y);
+                sum = t;
+            }
+
+            alignas(16) float sums[4];
+            alignas(16) float compensations[4];
+            _mm_store_ps(sums, sum);
+            _mm_store_ps(compensations, compensation);
+
+            // lanes & tail are combined with scalar Kahan
+            float total = 0.0f;
+            float c = 0.0f;
+            auto add = [&](float value) {
+                const float y = value - c;
+                const float t = total + y;
+                c = (t - total) - y;
+                total = t;
+            };
+
+            for (int lane = 0; lane < 4; ++lane)
+            {
+                add(sums[lane]);
+                add(-compensations[lane]);
+            }
+            for (; i < size; ++i)
+                add(data[i]);
+
+            return total;
+        }
+#endif
+
+#ifdef SIMD_SUM_AVX2
+        /////////////////////////////////////////////////////////////////
+        // AVX2 kernels
+        //
+        SIMD_SUM_TARGET_AVX2 inline uint64_t sum_u8_avx2(const uint8_t* data, size_t size)
+        {
+            const __m256i zero = _mm256_setzero_si256();
+            __m256i acc0 = zero, acc1 = zero;
+
+            size_t i = 0;
+            for (; i + 64 <= size; i += 64)
+            {
+                const __m256i bytes0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+                const __m256i bytes1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 32));
+                acc0 = _mm256_add_epi64(acc0, _mm256_sad_epu8(bytes0, zero));
+                acc1 = _mm256_add_epi64(acc1, _mm256_sad_epu8(bytes1, zero));
+            }
+
+            alignas(32) uint64_t lanes[4];
+            _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), _mm256_add_epi64(acc0, acc1));
+
+            uint64_t total = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+            for (; i < size; ++i)
+                total += data[i];
+
+            return total;
+        }
+
+        template <typename T>
+        SIMD_SUM_TARGET_AVX2 auto sum_i16_avx2(const T* data, size_t size)
+        {
+            static_assert(std::is_same_v<T, int16_t> || std::is_same_v<T, uint16_t>);
+            constexpr bool is_unsigned = std::is_unsigned_v<T>;
+            constexpr size_t block_size = 16 * 16384;
+
+            const __m256i ones = _mm256_set1_epi16(1);
+            const __m256i bias = _mm256_set1_epi16(is_unsigned ? static_cast<int16_t>(0x8000) : 0);
+
+            int64_t total = 0;
+            size_t i = 0;
+            const size_t vectorized_size = size - size % 16;
+
+            while (i < vectorized_size)
+            {
+                const size_t block_end = std::min(vectorized_size, i + block_size);
+
+                __m256i acc = _mm256_setzero_si256();
+                for (; i < block_end; i += 16)
+                {
+                    const __m256i shorts = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)), bias);
+                    acc = _mm256_add_epi32(acc, _mm256_madd_epi16(shorts, ones));
+                }
+
+                alignas(32) int32_t lanes[8];
+                _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+                for (int32_t lane : lanes)
+                    total += lane;
+            }
+
+            using TResult = std::conditional_t<is_unsigned, uint64_t, int64_t>;
+            TResult result = static_cast<TResult>(total);
+            if constexpr (is_unsigned)
+                result += 0x8000ull * vectorized_size;
+
+            for (; i < size; ++i)
+                result += data[i];
+
+            return result;
+        }
+
+        SIMD_SUM_TARGET_AVX2 inline double sum_float_avx2(const float* data, size_t size)
+        {
+            __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd(), acc2 = _mm256_setzero_pd(), acc3 = _mm256_setzero_pd();
+
+            size_t i = 0;
+            for (; i + 16 <= size; i += 16)
+            {
+                acc0 = _mm256_add_pd(acc0, _mm256_cvtps_pd(_mm_loadu_ps(data + i)));
+                acc1 = _mm256_add_pd(acc1, _mm256_cvtps_pd(_mm_loadu_ps(data + i + 4)));
+                acc2 = _mm256_add_pd(acc2, _mm256_cvtps_pd(_mm_loadu_ps(data + i + 8)));
+                acc3 = _mm256_add_pd(acc3, _mm256_cvtps_pd(_mm_loadu_ps(data + i + 12)));
+            }
+
+            alignas(32) double lanes[4];
+            _mm256_store_pd(lanes, _mm256_add_pd(_mm256_add_pd(acc0, acc1), _mm256_add_pd(acc2, acc3)));
+
+            double total = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+            for (; i < size; ++i)
+                total += data[i];
+
+            return total;
+        }
+#endif
+    }
+
+    /////////////////////////////////////////////////////////////////
+    // SumKernel<T> - vectorized sum of contiguous T, if there is one
+    //
+    template <typename T>
+    struct SumKernel
+    {
+        static constexpr bool is_vectorized = false;
+    };
+
+    template <>
+    struct SumKernel<uint8_t>
+    {
+        static constexpr bool is_vectorized = true;
+        using SumType = SumTraits<uint8_t>::SumType;
+
+        static SumType sum(const uint8_t* data, size_t size)
+        {
+#if defined(SIMD_SUM_AVX2)
+            static const auto kernel = cpu_features().avx2 ? Kernels::sum_u8_avx2 : Kernels::sum_u8_sse2;
+            return kernel(data, size);
+#elif defined(SIMD_SUM_X86)
+            return Kernels::sum_u8_sse2(data, size);
+#else
+            return Kernels::sum_in_blocks<SumType, uint32_t, (1 << 24)>(data, size);
+#endif
+        }
+    };
+
+    template <>
+    struct SumKernel<int16_t>
+    {
+        static constexpr bool is_vectorized = true;
+        using SumType = SumTraits<int16_t>::SumType;
+
+        static SumType sum(const int16_t* data, size_t size)
+        {
+#if defined(SIMD_SUM_AVX2)
+            static const auto kernel = cpu_features().avx2 ? Kernels::sum_i16_avx2<int16_t> : Kernels::sum_i16_sse2<int16_t>;
+            return kernel(data, size);
+#elif defined(SIMD_SUM_X86)
+            return Kernels::sum_i16_sse2(data, size);
+#else
+            return Kernels::sum_in_blocks<SumType, int32_t, (1 << 15)>(data, size);
+#endif
+        }
+    };
+
+    template <>
+    struct SumKernel<uint16_t>
+    {
+        static constexpr bool is_vectorized = true;
+        using SumType = SumTraits<uint16_t>::SumType;
+
+        static SumType sum(const uint16_t* data, size_t size)
+        {
+#if defined(SIMD_SUM_AVX2)
+            static const auto kernel = cpu_features().avx2 ? Kernels::sum_i16_avx2<uint16_t> : Kernels::sum_i16_sse2<uint16_t>;
+            return kernel(data, size);
+#elif defined(SIMD_SUM_X86)
+            return Kernels::sum_i16_sse2(data, size);
+#else
+            return Kernels::sum_in_blocks<SumType, uint32_t, (1 << 16)>(data, size);
+#endif
+        }
+    };
+
+    template <>
+    struct SumKernel<float>
+    {
+        static constexpr bool is_vectorized = true;
+        using SumType = SumTraits<float>::SumType;
+
+        static SumType sum(const float* data, size_t size)
+        {
+#if defined(SIMD_SUM_AVX2)
+            static const auto kernel = cpu_features().avx2 ? Kernels::sum_float_avx2 : Kernels::sum_float_sse2;
+            return kernel(data, size);
+#elif defined(SIMD_SUM_X86)
+            return Kernels::sum_float_sse2(data, size);
+#else
+            return Kernels::sum_float_portable(data, size);
+#endif
+        }
+    };
+
+    template <typename TContainer, typename = void>
+    struct IsContiguous : std::false_type
+    {
+    };
+
+    template <typename TContainer>
+    struct IsContiguous<TContainer, std::void_t<decltype(std::data(std::declval<const TContainer&>()))>>
+        : std::is_pointer<decltype(std::data(std::declval<const TContainer&>()))>
+    {
+    };
+
+    template <typename TContainer>
+    constexpr bool is_contiguous_v = IsContiguous<TContainer>::value;
+
+    // vectorized kernel for contiguous containers of supported types, Traits::sum otherwise
+    template <typename TContainer>
+    auto sum(const TContainer& container)
+    {
+        using T = std::remove_cv_t<std::remove_reference_t<decltype(*std::begin(container))>>;
+
+        if constexpr (SumKernel<T>::is_vectorized && is_contiguous_v<TContainer>)
+            return SumKernel<T>::sum(std::data(container), std::size(container));
+        else
+            return Traits::sum(container);
+    }
+
+    // compensated summation - error does not grow with the number of elements
+    inline float kahan_sum(const float* data, size_t size)
+    {
+#ifdef SIMD_SUM_X86
+        return Kernels::kahan_sum_sse2(data, size);
+#else
+        return Kernels::kahan_sum_portable(data, size);
+#endif
+    }
+
+    template <typename TContainer>
+    float kahan_sum(const TContainer& container)
+    {
+        return kahan_sum(std::data(container), std::size(container));
+    }
+}
+
+#endif // SIMD_SUM_HPP
@@ -0,0 +1,159 @@
+#ifndef SUM_TRAITS_HPP
+#define SUM_TRAITS_HPP
+
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+/////////////////////////////////////////////////////////////////
+// AccumulatorTraits<T> - type wide enough to sum many T values
+//
+// Integers are summed in 64 bits of the same signedness, float in double.
+// 64-bit integers and double have no wider type - use CheckedSumPolicy
+// to detect an overflow.
+//
+template <typename T, typename = void>
+struct AccumulatorTraits
+{
+    using type = T;
+};
+
+template <typename T>
+struct AccumulatorTraits<T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>>>
+{
+    using type = std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>;
+};
+
+template <>
+struct AccumulatorTraits<float>
+{
+    using type = double;
+};
+
+template <typename T>
+using Accumulator_t = typename AccumulatorTraits<T>::type;
+
+template <typename T>
+struct SumTraits
+{
+    using SumType = Accumulator_t<T>;
+    inline static const SumType zero = SumType();
+};
+
+// concatenation - total length is computed up front, so the result is allocated once
+template <typename TString>
+struct StringSumTraits
+{
+    using SumType = std::string;
+    inline static const std::string zero = std::string();
+
+    template <typename TIterator>
+    static void reserve(std::string& total, TIterator first, TIterator last)
+    {
+        size_t length = total.size();
+        for (; first != last; ++first)
+            length += std::string_view {*first}.size();
+
+        total.reserve(length);
+    }
+};
+
+template <>
+struct SumTraits<std::string> : StringSumTraits<std::string>
+{
+};
+
+template <>
+struct SumTraits<std::string_view> : StringSumTraits<std::string_view>
+{
+};
+
+template <typename TTraits, typename TIterator, typename = void>
+struct HasReserve : std::false_type
+{
+};
+
+template <typename TTraits, typename TIterator>
+struct HasReserve<TTraits, TIterator,
+    std::void_t<decltype(TTraits::reserve(std::declval<typename TTraits::SumType&>(), std::declval<TIterator>(), std::declval<TIterator>()))>>
+    : std::true_type
+{
+};
+
+template <typename T1, typename T2>
+struct SumPolicy
+{
+    static void sum(T1& total, const T2& item)
+    {
+        total += item;
+    }
+};
+
+// throws std::overflow_error instead of wrapping around (integers) or reaching infinity (floating point)
+template <typename T1, typename T2>
+struct CheckedSumPolicy
+{
+    static void sum(T1& total, const T2& item)
+    {
+        if constexpr (std::is_integral_v<T1>)
+        {
+            using U = std::make_unsigned_t<T1>;
+
+            const T1 value = static_cast<T1>(item);
+            const T1 result = static_cast<T1>(static_cast<U>(total) + static_cast<U>(value));
+
+            // one predictable branch - sign tests would mispredict on data of mixed signs
+            bool overflow;
+            if constexpr (std::is_signed_v<T1>)
+                overflow = ((total ^ result) & (value ^ result)) < 0; // operands of the same sign, result of the other
+            else
+                overflow = result < total;
+
+            if (overflow)
+                throw std::overflow_error("sum overflow");
+
+            total = result;
+        }
+        else if constexpr (std::is_floating_point_v<T1>)
+        {
+            total += item;
+
+            if (std::isinf(total) && !std::isinf(item))
+                throw std::overflow_error("sum overflow");
+        }
+        else
+        {
+            total += item;
+        }
+    }
+};
+
+namespace Traits
+{
+    template <template <typename, typename> class TSumPolicy = SumPolicy, typename TContainer>
+    auto sum(const TContainer& container)
+    {
+        using T = std::remove_cv_t<std::remove_reference_t<decltype(*std::begin(container))>>;
+
+        using TResult = typename SumTraits<T>::SumType;
+        TResult result = SumTraits<T>::zero;
+
+        if constexpr (HasReserve<SumTraits<T>, decltype(std::begin(container))>::value)
+            SumTraits<T>::reserve(result, std::begin(container), std::end(container));
+
+        for (auto it = std::begin(container); it != std::end(container); ++it)
+        {
+            //result += *it;
+            TSumPolicy<TResult, T>::sum(result, *it);
+        }
+
+        return result;
+    }
+}
+
+#endif // SUM_TRAITS_HPP
@@ -1,6 +1,19 @@
 #include "catch.hpp"
+#include "expression_templates.hpp"
+#include "parallel_sum.hpp"
+#include "simd_sum.hpp"
+#include "sum_traits.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <future>
 #include <iostream>
+#include <limits>
+#include <list>
+#include <numeric>
+#include <random>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <vector>
 
@@ -89,65 +102,513 @@ namespace ModernCpp
     }
 }
 
-template <typename T>
-struct SumTraits
+TEST_CASE("Test")
 {
-    using SumType = T;
-    inline static const T zero = T();
-};
+    vector<int> vec = {1, 2, 3};
+
+    REQUIRE(Cpp98::sum(vec) == 6);
+
+    int tab[3] = {1, 2, 3};
+
+    REQUIRE(ModernCpp::sum(tab) == 6);
 
-template <>
-struct SumTraits<uint8_t>
+    // vector<vector<int>> data = {{1, 2, 3}, {4, 5, 6}};
+    // auto result = ModernCpp::sum(data);
+
+    vector<uint8_t> numbers = {250, 50};
+
+    REQUIRE(Traits::sum(numbers) == 300);
+
+    vector<string> words = {"a", "bc", "d"};
+    REQUIRE(Traits::sum(words) == "abcd"s);
+}
+
+TEST_CASE("accumulator widening")
 {
-    using SumType = uint64_t;
-    inline static constexpr uint64_t zero = 0;
-};
+    static_assert(is_same_v<SumTraits<int8_t>::SumType, int64_t>);
+    static_assert(is_same_v<SumTraits<uint8_t>::SumType, uint64_t>);
+    static_assert(is_same_v<SumTraits<int16_t>::SumType, int64_t>);
+    static_assert(is_same_v<SumTraits<uint32_t>::SumType, uint64_t>);
+    static_assert(is_same_v<SumTraits<int>::SumType, int64_t>);
+    static_assert(is_same_v<SumTraits<int64_t>::SumType, int64_t>);
+    static_assert(is_same_v<SumTraits<float>::SumType, double>);
+    static_assert(is_same_v<SumTraits<double>::SumType, double>);
+    static_assert(is_same_v<SumTraits<string>::SumType, string>);
+
+    SECTION("sum of ints does not overflow int")
+    {
+        vector<int> numbers(4, std::numeric_limits<int>::max());
+        REQUIRE(Traits::sum(numbers) == 4LL * std::numeric_limits<int>::max());
 
-template <typename T1, typename T2>
-struct SumPolicy
+        vector<int16_t> shorts(3, std::numeric_limits<int16_t>::min());
+        REQUIRE(Traits::sum(shorts) == 3 * -32768);
+    }
+
+    SECTION("floats are summed in double")
+    {
+        vector<float> floats(1'000'000, 0.1f);
+        REQUIRE(Traits::sum(floats) == Catch::Detail::Approx(1'000'000 * static_cast<double>(0.1f)).epsilon(1e-12));
+    }
+
+    SECTION("checked policy detects overflow of an accumulator")
+    {
+        vector<int64_t> big = {std::numeric_limits<int64_t>::max(), 1};
+        REQUIRE_THROWS_AS(Traits::sum<CheckedSumPolicy>(big), std::overflow_error);
+
+        vector<int64_t> small = {std::numeric_limits<int64_t>::min(), -1};
+        REQUIRE_THROWS_AS(Traits::sum<CheckedSumPolicy>(small), std::overflow_error);
+
+        vector<uint64_t> unsigned_big = {std::numeric_limits<uint64_t>::max(), 1};
+        REQUIRE_THROWS_AS(Traits::sum<CheckedSumPolicy>(unsigned_big), std::overflow_error);
+
+        vector<double> huge = {std::numeric_limits<double>::max(), std::numeric_limits<double>::max()};
+        REQUIRE_THROWS_AS(Traits::sum<CheckedSumPolicy>(huge), std::overflow_error);
+    }
+
+    SECTION("checked policy gives the same result when nothing overflows")
+    {
+        vector<int64_t> numbers = {std::numeric_limits<int64_t>::max(), -5, std::numeric_limits<int64_t>::min(), 7};
+        REQUIRE(Traits::sum<CheckedSumPolicy>(numbers) == Traits::sum(numbers));
+
+        vector<uint8_t> bytes = {250, 50};
+        REQUIRE(Traits::sum<CheckedSumPolicy>(bytes) == 300);
+    }
+}
+
+TEST_CASE("accumulator widening - cost", "[!benchmark]")
 {
-    static void sum(T1& total, const T2& item)
+    std::mt19937 rnd {665};
+
+    const size_t size = 1'000'000;
+    vector<int> ints(size);
+    vector<int64_t> longs(size);
+    vector<float> floats(size);
+    for (size_t i = 0; i < size; ++i)
     {
-        total += item;
+        ints[i] = static_cast<int>(rnd()) / 4;
+        longs[i] = static_cast<int64_t>(rnd());
+        floats[i] = static_cast<float>(rnd() % 1000) / 8.0f;
     }
-};
 
-namespace Traits
+    BENCHMARK("int - narrow accumulator")
+    {
+        return std::accumulate(ints.begin(), ints.end(), 0u); // unsigned - wrap around is not UB
+    };
+
+    BENCHMARK("int - Traits::sum")
+    {
+        return Traits::sum(ints);
+    };
+
+    BENCHMARK("int - Traits::sum<CheckedSumPolicy>")
+    {
+        return Traits::sum<CheckedSumPolicy>(ints);
+    };
+
+    BENCHMARK("int64_t - Traits::sum")
+    {
+        return Traits::sum(longs);
+    };
+
+    BENCHMARK("int64_t - Traits::sum<CheckedSumPolicy>")
+    {
+        return Traits::sum<CheckedSumPolicy>(longs);
+    };
+
+    BENCHMARK("float - narrow accumulator")
+    {
+        return std::accumulate(floats.begin(), floats.end(), 0.0f);
+    };
+
+    BENCHMARK("float - Traits::sum")
+    {
+        return Traits::sum(floats);
+    };
+
+    BENCHMARK("float - Traits::sum<CheckedSumPolicy>")
+    {
+        return Traits::sum<CheckedSumPolicy>(floats);
+    };
+}
+
+TEST_CASE("sum of strings")
 {
-    template <typename TContainer>
-    auto sum(const TContainer& container)
+    SECTION("result is allocated once")
     {
-        using T = std::remove_cv_t<std::remove_reference_t<decltype(*begin(container))>>;
+        vector<string> words(1000, "word");
 
-        using TResult = typename SumTraits<T>::SumType;
-        TResult result = SumTraits<T>::zero;
-        for (auto it = std::begin(container); it != std::end(container); ++it)
+        const auto text = Traits::sum(words);
+        REQUIRE(text.size() == 4000);
+        REQUIRE(text.capacity() < 4000 * 3 / 2);
+    }
+
+    SECTION("string_views are concatenated into std::string")
+    {
+        const string text = "one two three";
+        vector<string_view> words = {string_view(text).substr(0, 3), string_view(text).substr(4, 3), string_view(text).substr(8)};
+
+        static_assert(is_same_v<decltype(Traits::sum(words)), string>);
+        REQUIRE(Traits::sum(words) == "onetwothree");
+    }
+
+    SECTION("non random access ranges")
+    {
+        list<string> words = {"a", "bc", "", "def"};
+        REQUIRE(Traits::sum(words) == "abcdef");
+    }
+}
+
+TEST_CASE("sum of strings vs. appending", "[!benchmark]")
+{
+    std::mt19937 rnd {665};
+
+    vector<string> words(1'000'000);
+    for (auto& w : words)
+        w.assign(1 + rnd() % 8, static_cast<char>('a' + rnd() % 26));
+
+    vector<string_view> views(words.begin(), words.end());
+
+    BENCHMARK("appending with +=")
+    {
+        string result;
+        for (const auto& w : words)
+            result += w;
+        return result;
+    };
+
+    BENCHMARK("Traits::sum<string>")
+    {
+        return Traits::sum(words);
+    };
+
+    BENCHMARK("Traits::sum<string_view>")
+    {
+        return Traits::sum(views);
+    };
+}
+
+
+TEST_CASE("expression templates")
+{
+    using namespace ElementWise;
+
+    vector<int> a = {1, 2, 3, 4};
+    vector<int> b = {5, 6, 7, 8};
+    vector<int> c = {1, 1, 1, 1};
+
+    SECTION("expression is evaluated lazily")
+    {
+        auto expr = a * b + c;
+
+        REQUIRE(expr.size() == 4);
+        REQUIRE(expr[2] == 22);
+
+        a[2] = 0; // expressions keep references to containers
+        REQUIRE(expr[2] == 1);
+    }
+
+    SECTION("sum of expression")
+    {
+        REQUIRE(ElementWise::sum(a * b + c) == 74);
+        REQUIRE(ElementWise::sum(a - b) == -16);
+        REQUIRE(ElementWise::sum(2 * a + 1) == 24);
+    }
+
+    SECTION("evaluate materializes expression")
+    {
+        vector<int> result = evaluate((a + b) * 2 - c);
+        REQUIRE(result == vector<int> {11, 15, 19, 23});
+    }
+
+    SECTION("arithmetic is done in the accumulator type of SumTraits")
+    {
+        vector<uint8_t> x = {200, 250};
+        vector<uint8_t> y = {100, 200};
+
+        static_assert(std::is_same_v<decltype(ElementWise::sum(x * y)), int64_t>); // uint8_t * uint8_t is int
+        REQUIRE(ElementWise::sum(x * y + x) == 200 * 100 + 250 * 200 + 200 + 250);
+    }
+
+    SECTION("elements are promoted like C++ operands - same values for operator[], evaluate & sum")
+    {
+        vector<uint8_t> x = {200, 250};
+        vector<uint8_t> y = {100, 200};
+
+        static_assert(std::is_same_v<decltype(x * y)::value_type, int>);
+        REQUIRE((x * y)[1] == 250 * 200);
+        REQUIRE(evaluate(x * y) == vector<int> {200 * 100, 250 * 200});
+        REQUIRE(ElementWise::sum(x * y) == (x * y)[0] + (x * y)[1]);
+    }
+}
+
+TEST_CASE("expression templates vs. temporaries", "[!benchmark]")
+{
+    using namespace ElementWise;
+
+    const size_t size = 1'000'000;
+
+    vector<double> a(size), b(size), c(size);
+    std::iota(a.begin(), a.end(), 0.0);
+    std::iota(b.begin(), b.end(), 1.0);
+    std::iota(c.begin(), c.end(), 2.0);
+
+    BENCHMARK("temporaries - sum(a * b + c)")
+    {
+        vector<double> ab(size);
+        for (size_t i = 0; i < size; ++i)
+            ab[i] = a[i] * b[i];
+
+        vector<double> abc(size);
+        for (size_t i = 0; i < size; ++i)
+            abc[i] = ab[i] + c[i];
+
+        return Traits::sum(abc);
+    };
+
+    BENCHMARK("expression template - sum(a * b + c)")
+    {
+        return ElementWise::sum(a * b + c);
+    };
+
+    BENCHMARK("hand-written loop - sum(a * b + c)")
+    {
+        double result = 0.0;
+        for (size_t i = 0; i < size; ++i)
+            result += a[i] * b[i] + c[i];
+        return result;
+    };
+}
+
+TEST_CASE("vectorized sum")
+{
+    std::mt19937 rnd {665};
+
+    SECTION("bytes are widened to uint64_t")
+    {
+        vector<uint8_t> bytes(100'003);
+        for (auto& b : bytes)
+            b = static_cast<uint8_t>(rnd());
+
+        static_assert(std::is_same_v<decltype(Simd::sum(bytes)), uint64_t>);
+        REQUIRE(Simd::sum(bytes) == Traits::sum(bytes));
+        REQUIRE(Simd::Kernels::sum_in_blocks<uint64_t, uint32_t, 1024>(bytes.data(), bytes.size()) == Traits::sum(bytes));
+    }
+
+    SECTION("shorts are widened to 64 bits")
+    {
+        vector<int16_t> shorts(300'003, std::numeric_limits<int16_t>::min());
+        shorts.back() = 1;
+        REQUIRE(Simd::sum(shorts) == std::accumulate(shorts.begin(), shorts.end(), int64_t {0}));
+
+        for (auto& s : shorts)
+            s = static_cast<int16_t>(rnd());
+        REQUIRE(Simd::sum(shorts) == std::accumulate(shorts.begin(), shorts.end(), int64_t {0}));
+
+        vector<uint16_t> ushorts(300'003, std::numeric_limits<uint16_t>::max());
+        REQUIRE(Simd::sum(ushorts) == 300'003ULL * 65535);
+
+        for (auto& s : ushorts)
+            s = static_cast<uint16_t>(rnd());
+        REQUIRE(Simd::sum(ushorts) == std::accumulate(ushorts.begin(), ushorts.end(), uint64_t {0}));
+    }
+
+    SECTION("floats with multiple accumulators")
+    {
+        vector<float> floats(100'003);
+        for (auto& f : floats)
+            f = static_cast<float>(rnd() % 16) / 8.0f; // all partial sums are exactly representable
+
+        REQUIRE(Simd::sum(floats) == Traits::sum(floats));
+    }
+
+    SECTION("Kahan summation compensates rounding errors")
+    {
+        vector<float> floats(1'000'000, 0.1f);
+        const double exact = 1'000'000 * static_cast<double>(0.1f);
+
+        const double naive_error = std::abs(std::accumulate(floats.begin(), floats.end(), 0.0f) - exact);
+        const double kahan_error = std::abs(Simd::kahan_sum(floats) - exact);
+
+        REQUIRE(kahan_error < 0.01);
+        REQUIRE(kahan_error < naive_error);
+    }
+
+    SECTION("other containers fall back to Traits::sum")
+    {
+        list<uint8_t> bytes = {250, 50};
+        REQUIRE(Simd::sum(bytes) == 300);
+    }
+}
+
+TEST_CASE("vectorized sum vs. Traits::sum", "[!benchmark]")
+{
+    std::mt19937 rnd {665};
+
+    for (size_t size : {1'000u, 64'000u, 4'000'000u})
+    {
+        vector<uint8_t> bytes(size);
+        vector<int16_t> shorts(size);
+        vector<float> floats(size);
+        for (size_t i = 0; i < size; ++i)
         {
-            //result += *it;
-            SumPolicy<TResult, T>::sum(result, *it);
+            bytes[i] = static_cast<uint8_t>(rnd());
+            shorts[i] = static_cast<int16_t>(rnd());
+            floats[i] = static_cast<float>(rnd() % 1000) / 8.0f;
         }
 
-        return result;
+        const string suffix = " - " + to_string(size);
+
+        BENCHMARK("Traits::sum<uint8_t>" + suffix)
+        {
+            return Traits::sum(bytes);
+        };
+
+        BENCHMARK("Simd::sum<uint8_t>" + suffix)
+        {
+            return Simd::sum(bytes);
+        };
+
+        BENCHMARK("Traits::sum<int16_t>" + suffix)
+        {
+            return Traits::sum(shorts);
+        };
+
+        BENCHMARK("Simd::sum<int16_t>" + suffix)
+        {
+            return Simd::sum(shorts);
+        };
+
+        BENCHMARK("Traits::sum<float>" + suffix)
+        {
+            return Traits::sum(floats);
+        };
+
+        BENCHMARK("Simd::sum<float>" + suffix)
+        {
+            return Simd::sum(floats);
+        };
+
+        BENCHMARK("Simd::kahan_sum<float>" + suffix)
+        {
+            return Simd::kahan_sum(floats);
+        };
     }
 }
 
-TEST_CASE("Test")
+TEST_CASE("parallel sum")
 {
-    vector<int> vec = {1, 2, 3};
+    std::mt19937 rnd {665};
 
-    REQUIRE(Cpp98::sum(vec) == 6);
+    SECTION("integers")
+    {
+        vector<uint8_t> bytes(1'000'003);
+        for (auto& b : bytes)
+            b = static_cast<uint8_t>(rnd());
 
-    int tab[3] = {1, 2, 3};
+        Parallel::ThreadPool pool {4};
+        REQUIRE(Parallel::sum(bytes, pool) == Traits::sum(bytes));
+        REQUIRE(Parallel::sum(bytes, pool, 1000) == Traits::sum(bytes));
+    }
 
-    REQUIRE(ModernCpp::sum(tab) == 6);
+    SECTION("floating point result does not depend on number of threads")
+    {
+        vector<float> floats(1'000'003);
+        for (auto& f : floats)
+            f = static_cast<float>(rnd()) / static_cast<float>(rnd.max());
 
-    // vector<vector<int>> data = {{1, 2, 3}, {4, 5, 6}};
-    // auto result = ModernCpp::sum(data);
+        Parallel::ThreadPool single {1};
+        const auto expected = Parallel::sum(floats, single, 4096);
 
-    vector<uint8_t> numbers = {250, 50};
+        for (size_t threads : {2, 3, 8})
+        {
+            Parallel::ThreadPool pool {threads};
+            REQUIRE(Parallel::sum(floats, pool, 4096) == expected);
+        }
+    }
 
-    REQUIRE(Traits::sum(numbers) == 300);
+    SECTION("small & non random access containers")
+    {
+        Parallel::ThreadPool pool {2};
 
-    vector<string> words = {"a", "bc", "d"};
-    REQUIRE(Traits::sum(words) == "abcd"s);
+        vector<int> empty;
+        REQUIRE(Parallel::sum(empty, pool) == 0);
+
+        list<uint8_t> bytes = {250, 50};
+        REQUIRE(Parallel::sum(bytes, pool) == 300);
+    }
+
+    SECTION("nested sums on the same pool do not deadlock")
+    {
+        Parallel::ThreadPool pool {2};
+        vector<vector<int>> rows(8, vector<int>(10'000, 1));
+
+        vector<std::future<long long>> row_sums;
+        for (const auto& row : rows)
+            row_sums.push_back(pool.submit([&row, &pool] { return static_cast<long long>(Parallel::sum(row, pool, 1000)); }));
+
+        long long total = 0;
+        for (auto& row_sum : row_sums)
+            total += row_sum.get();
+        REQUIRE(total == 80'000);
+    }
+
+    SECTION("checked policy")
+    {
+        Parallel::ThreadPool pool {2};
+
+        vector<int64_t> big(4000, std::numeric_limits<int64_t>::max() / 1000);
+        REQUIRE_THROWS_AS(Parallel::sum<CheckedSumPolicy>(big, pool, 1000), std::overflow_error);
+
+        vector<int> ints(4000, 3);
+        REQUIRE(Parallel::sum<CheckedSumPolicy>(ints, pool, 1000) == 12'000);
+    }
+}
+
+TEST_CASE("parallel sum - scaling", "[!benchmark]")
+{
+    std::mt19937 rnd {665};
+
+    const size_t size = 64'000'000;
+    vector<uint8_t> bytes(size);
+    vector<double> doubles(size / 8);
+    for (size_t i = 0; i < size; ++i)
+        bytes[i] = static_cast<uint8_t>(rnd());
+    for (auto& d : doubles)
+        d = static_cast<double>(rnd());
+
+    BENCHMARK("Traits::sum<uint8_t>")
+    {
+        return Traits::sum(bytes);
+    };
+
+    BENCHMARK("Traits::sum<double>")
+    {
+        return Traits::sum(doubles);
+    };
+
+    // powers of 2 and always all cores - e.g. 1, 2, 4, 6 on a 6 core machine
+    const size_t all_cores = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<size_t> thread_counts;
+    for (size_t threads = 1; threads < std::max<size_t>(4, all_cores); threads *= 2)
+        thread_counts.push_back(threads);
+    thread_counts.push_back(std::max<size_t>(4, all_cores));
+    if (all_cores < 4)
+        thread_counts.insert(std::lower_bound(thread_counts.begin(), thread_counts.end(), all_cores), all_cores);
+    thread_counts.erase(std::unique(thread_counts.begin(), thread_counts.end()), thread_counts.end());
+
+    for (size_t threads : thread_counts)
+    {
+        Parallel::ThreadPool pool {threads};
+        const string suffix = " - " + to_string(threads) + " threads";
+
+        BENCHMARK("Parallel::sum<uint8_t>" + suffix)
+        {
+            return Parallel::sum(bytes, pool);
+        };
+
+        BENCHMARK("Parallel::sum<double>" + suffix)
+        {
+            return Parallel::sum(doubles, pool);
+        };
+    }
 }